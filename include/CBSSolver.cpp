@@ -0,0 +1,681 @@
+// Local lib includes
+#include "CBSSolver.hpp"
+#include "ThreadPool.hpp"
+#include "Tracer.hpp"
+
+// Standard Includes
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+using namespace PathPlanner;
+using Position = PathPlanner::PathFinder::Position;
+
+namespace
+{
+// Position of a unit at a given time step. Units wait at their target after arrival, or leave the
+// map when staysAtTarget is false. Returns false if the unit is not on the map at that time
+bool positionAt(const std::vector<Position> &path, int time, bool staysAtTarget, Position &pos)
+{
+    if (path.empty())
+    {
+        return false;
+    }
+    if (time < static_cast<int>(path.size()))
+    {
+        pos = path[time];
+        return true;
+    }
+    pos = path.back();
+    return staysAtTarget;
+}
+
+// Index of the move direction between two adjacent cells, used to key edge constraints
+uint64_t directionOf(const Position &from, const Position &to)
+{
+    if (to.x != from.x)
+    {
+        return to.x > from.x ? 0 : 1;
+    }
+    return to.y > from.y ? 2 : 3;
+}
+} // namespace
+
+/**
+ * @brief Constructor for the CBSSolver Class
+ *
+ * @param pathFinder PathFinder providing the map and the unit set
+ * @param options Suboptimality bound, thread count and search limits
+ *
+ */
+CBSSolver::CBSSolver(const PathFinder &pathFinder, Options options)
+    : m_pathFinder(pathFinder), m_options(options)
+{
+    if (m_options.suboptimality < 1.0)
+    {
+        throw std::invalid_argument("Suboptimality factor must be at least 1");
+    }
+}
+
+/**
+ * @brief Solve for all units of the map using their parsed start and target positions
+ *
+ * @return Result with conflict free paths if a solution was found within the node limit
+ *
+ */
+CBSSolver::Result CBSSolver::Solve() const
+{
+    std::vector<Position> starts, targets;
+    for (size_t i = 0; i < m_pathFinder.GetUnitCount(); ++i)
+    {
+        starts.push_back(m_pathFinder.GetStartPosition(static_cast<int>(i)));
+        targets.push_back(m_pathFinder.GetTargetPosition(static_cast<int>(i)));
+    }
+    return Solve(starts, targets);
+}
+
+/**
+ * @brief Run Conflict-Based Search for the given units. Units whose target is unreachable from their
+ * start get an empty path and are ignored for conflicts. Units sharing a target with another unit
+ * leave the map on arrival, all other units keep occupying their target
+ *
+ * @param starts,targets Start and target position of each unit
+ *
+ * @return Result with conflict free paths if a solution was found within the node and time limits
+ *
+ */
+CBSSolver::Result CBSSolver::Solve(const std::vector<Position> &starts,
+                                   const std::vector<Position> &targets) const
+{
+    TraceSpan span("Solve", "CBSSolver", "units", static_cast<int64_t>(starts.size()));
+    if (starts.size() != targets.size())
+    {
+        throw std::invalid_argument("Every unit needs exactly one start and one target");
+    }
+
+    const size_t unitCount = starts.size();
+    std::vector<bool> staysAtTarget(unitCount);
+    for (size_t i = 0; i < unitCount; ++i)
+    {
+        staysAtTarget[i] = std::count(targets.begin(), targets.end(), targets[i]) == 1;
+    }
+
+    // Units in different connected components can never reach their targets
+    std::vector<bool> reachable(unitCount);
+    for (size_t i = 0; i < unitCount; ++i)
+    {
+        reachable[i] = m_pathFinder.AreConnected(starts[i], targets[i]);
+        if (!reachable[i])
+        {
+            std::cerr << "No valid path found for unit " << i << std::endl;
+        }
+    }
+
+    const auto deadline = m_options.timeLimit.count() > 0 ? Clock::now() + m_options.timeLimit
+                                                           : Clock::time_point::max();
+    ThreadPool pool(m_options.threadCount);
+    const size_t batchSize = m_options.batchSize ? m_options.batchSize : pool.Size();
+
+    Result result;
+    auto timedOut = [&]() {
+        if (Clock::now() < deadline)
+        {
+            return false;
+        }
+        std::cerr << "Conflict-Based Search ran out of time after " << result.generatedNodes
+                  << " nodes" << std::endl;
+        result.timedOut = true;
+        return true;
+    };
+
+    // Root node plans the units one after another, each avoiding the units planned before it
+    auto root = std::make_shared<TreeNode>();
+    root->paths.resize(unitCount, std::make_shared<const Path>());
+    root->lowerBounds.resize(unitCount, 0);
+    for (size_t i = 0; i < unitCount; ++i)
+    {
+        if (!reachable[i])
+        {
+            continue;
+        }
+        Plan plan = planUnit(i, starts[i], targets[i], {},
+                             buildConflictTable(root->paths, staysAtTarget, i), staysAtTarget[i],
+                             deadline);
+        if (!plan.path)
+        {
+            timedOut();
+            return result;
+        }
+        root->paths[i] = plan.path;
+        root->lowerBounds[i] = plan.lowerBound;
+        root->lowerBound += plan.lowerBound;
+    }
+    evaluateNode(*root, staysAtTarget);
+
+    // The open list orders nodes by the sum of their units' lower bounds, which bounds the optimal
+    // cost from below. The focal list holds the open nodes costing at most the suboptimality
+    // factor times that bound, fewest conflicts first, and is the list nodes are expanded from.
+    // Open nodes above the bound wait in cost order until the bound reaches them
+    auto lowerBounded = [](const std::shared_ptr<TreeNode> &a, const std::shared_ptr<TreeNode> &b) {
+        return a->lowerBound != b->lowerBound ? a->lowerBound < b->lowerBound : a->id < b->id;
+    };
+    auto cheaper = [](const std::shared_ptr<TreeNode> &a, const std::shared_ptr<TreeNode> &b) {
+        return a->cost != b->cost ? a->cost < b->cost : a->id < b->id;
+    };
+    auto fewerConflicts = [](const std::shared_ptr<TreeNode> &a,
+                             const std::shared_ptr<TreeNode> &b) {
+        if (a->conflictCount != b->conflictCount)
+        {
+            return a->conflictCount < b->conflictCount;
+        }
+        return a->cost != b->cost ? a->cost < b->cost : a->id < b->id;
+    };
+    std::set<std::shared_ptr<TreeNode>, decltype(lowerBounded)> openList(lowerBounded);
+    std::set<std::shared_ptr<TreeNode>, decltype(fewerConflicts)> focalList(fewerConflicts);
+    std::set<std::shared_ptr<TreeNode>, decltype(cheaper)> waitingList(cheaper);
+    double bound = root->lowerBound * m_options.suboptimality;
+    openList.insert(root);
+    if (root->cost <= bound)
+    {
+        focalList.insert(root);
+    }
+    else
+    {
+        waitingList.insert(root);
+    }
+    result.generatedNodes = 1;
+
+    while (!openList.empty() && result.generatedNodes < m_options.maxNodes)
+    {
+        if (timedOut())
+        {
+            return result;
+        }
+
+        // Node lower bounds never drop below their parent's, so the bound only rises and the
+        // waiting nodes it reaches are moved into the focal list
+        if ((*openList.begin())->lowerBound * m_options.suboptimality > bound)
+        {
+            bound = (*openList.begin())->lowerBound * m_options.suboptimality;
+        }
+        while (!waitingList.empty() && (*waitingList.begin())->cost <= bound)
+        {
+            focalList.insert(*waitingList.begin());
+            waitingList.erase(waitingList.begin());
+        }
+
+        std::vector<std::shared_ptr<TreeNode>> batch;
+        while (!focalList.empty() && batch.size() < batchSize)
+        {
+            batch.push_back(*focalList.begin());
+            focalList.erase(focalList.begin());
+            openList.erase(batch.back());
+        }
+        if (batch.empty())
+        {
+            // Every node costs at most the factor times its own lower bound, so this only guards
+            // against rounding of the bound
+            batch.push_back(*openList.begin());
+            waitingList.erase(batch.back());
+            openList.erase(batch.back());
+        }
+
+        for (const auto &node : batch)
+        {
+            if (node->conflictCount == 0)
+            {
+                result.solved = true;
+                result.cost = node->cost;
+                result.resolvedConflicts = node->resolvedConflicts;
+                for (const auto &path : node->paths)
+                {
+                    result.paths.push_back(*path);
+                }
+                return result;
+            }
+        }
+
+        // Split every node of the batch on its first conflict, replanning children in parallel
+        std::vector<std::future<std::shared_ptr<TreeNode>>> children;
+        for (const auto &node : batch)
+        {
+            const Conflict &conflict = node->firstConflict;
+            for (int side = 0; side < 2; ++side)
+            {
+                children.push_back(pool.Submit([&, node, conflict, side]() {
+                    auto child = std::make_shared<TreeNode>(*node);
+                    size_t unit = side == 0 ? conflict.firstUnit : conflict.secondUnit;
+                    Constraint constraint;
+                    constraint.unit = unit;
+                    constraint.time = conflict.time;
+                    constraint.isEdge = conflict.isEdge;
+                    constraint.position =
+                        side == 0 ? conflict.secondPosition : conflict.firstPosition;
+                    constraint.fromPosition =
+                        side == 0 ? conflict.firstPosition : conflict.secondPosition;
+                    if (!conflict.isEdge)
+                    {
+                        constraint.position = conflict.firstPosition;
+                    }
+                    child->constraints.push_back(constraint);
+                    child->resolvedConflicts.push_back(conflict);
+
+                    Plan plan = planUnit(unit, starts[unit], targets[unit], child->constraints,
+                                         buildConflictTable(child->paths, staysAtTarget, unit),
+                                         staysAtTarget[unit], deadline);
+                    if (!plan.path)
+                    {
+                        return std::shared_ptr<TreeNode>();
+                    }
+                    child->paths[unit] = plan.path;
+                    // The replanned unit is more constrained than in the parent, so its bound
+                    // can only tighten
+                    const int lowerBound = std::max(plan.lowerBound, node->lowerBounds[unit]);
+                    child->lowerBound += lowerBound - child->lowerBounds[unit];
+                    child->lowerBounds[unit] = lowerBound;
+                    evaluateNode(*child, staysAtTarget);
+                    return child;
+                }));
+            }
+        }
+        result.expandedNodes += batch.size();
+
+        for (auto &future : children)
+        {
+            auto child = future.get();
+            if (child)
+            {
+                child->id = result.generatedNodes++;
+                openList.insert(child);
+                if (child->cost <= bound)
+                {
+                    focalList.insert(child);
+                }
+                else
+                {
+                    waitingList.insert(child);
+                }
+            }
+        }
+    }
+
+    std::cerr << "Conflict-Based Search gave up after " << result.generatedNodes << " nodes"
+              << std::endl;
+    return result;
+}
+
+/**
+ * @brief Compute the sum of path lengths and the conflicts of a constraint tree node
+ *
+ */
+void CBSSolver::evaluateNode(TreeNode &node, const std::vector<bool> &staysAtTarget) const
+{
+    node.cost = 0;
+    for (const auto &path : node.paths)
+    {
+        if (!path->empty())
+        {
+            node.cost += static_cast<int>(path->size()) - 1;
+        }
+    }
+    findFirstConflict(node.paths, staysAtTarget, node.firstConflict, node.conflictCount);
+}
+
+/**
+ * @brief Collect the cells and moves of the current paths of all units but one, so the low level
+ * can count the conflicts a candidate path would cause
+ *
+ * @param paths Current path of every unit
+ * @param staysAtTarget Whether each unit keeps occupying its target after arrival
+ * @param skipUnit Unit being replanned, left out of the table
+ *
+ * @return ConflictTable of the other units
+ *
+ */
+CBSSolver::ConflictTable CBSSolver::buildConflictTable(
+    const std::vector<std::shared_ptr<const Path>> &paths, const std::vector<bool> &staysAtTarget,
+    size_t skipUnit) const
+{
+    const auto version = m_pathFinder.GetMapVersion();
+    ConflictTable table;
+    table.cells = static_cast<size_t>(version->map.Rows()) * version->map.Cols();
+    table.parkedSince.assign(table.cells, INT_MAX);
+    for (size_t unit = 0; unit < paths.size(); ++unit)
+    {
+        if (unit != skipUnit)
+        {
+            table.lastTime = std::max(table.lastTime, static_cast<int>(paths[unit]->size()) - 1);
+        }
+    }
+    table.vertices.assign(table.cells * (table.lastTime + 1), 0);
+    table.edges.assign(table.vertices.size(), 0);
+
+    const size_t cols = version->map.Cols();
+    auto cellOf = [cols](const Position &pos) { return static_cast<size_t>(pos.x) * cols + pos.y; };
+    for (size_t unit = 0; unit < paths.size(); ++unit)
+    {
+        const Path &path = *paths[unit];
+        if (unit == skipUnit || path.empty())
+        {
+            continue;
+        }
+        const int last = static_cast<int>(path.size()) - 1;
+        for (int time = 0; time <= last; ++time)
+        {
+            const size_t index = time * table.cells + cellOf(path[time]);
+            if (time < last || !staysAtTarget[unit])
+            {
+                ++table.vertices[index];
+            }
+            // A move back along this step at the same time would swap cells with the unit
+            if (time > 0 && !(path[time - 1] == path[time]))
+            {
+                table.edges[time * table.cells + cellOf(path[time - 1])] |=
+                    1 << directionOf(path[time], path[time - 1]);
+            }
+        }
+        if (staysAtTarget[unit])
+        {
+            int &parked = table.parkedSince[cellOf(path.back())];
+            parked = std::min(parked, last);
+        }
+    }
+    return table;
+}
+
+/**
+ * @brief Focal space-time search for a single unit honoring the vertex and edge constraints
+ * addressed to it. Waiting in place is allowed and costs one time step like a move. Among the
+ * states within the suboptimality factor of the cheapest open state, the one with the fewest
+ * conflicts with the other units is expanded first, so with a factor of 1 this is an A* breaking
+ * ties by conflicts
+ *
+ * @param unit Index of the unit being planned
+ * @param start,target Start and target position of the unit
+ * @param constraints All constraints of the constraint tree node, filtered by unit
+ * @param conflicts Current paths of the other units
+ * @param staysAtTarget Whether the unit keeps occupying its target after arrival
+ * @param deadline Time after which the search is abandoned
+ *
+ * @return Plan with the path and a lower bound on the optimal path cost, a null path if none
+ * exists or the deadline passed
+ *
+ */
+CBSSolver::Plan CBSSolver::planUnit(size_t unit, const Position &start, const Position &target,
+                                    const std::vector<Constraint> &constraints,
+                                    const ConflictTable &conflicts, bool staysAtTarget,
+                                    Clock::time_point deadline) const
+{
+    // Plan against one map version so concurrent terrain edits cannot change the map mid search
+    const auto version = m_pathFinder.GetMapVersion();
+    const int rows = version->map.Rows();
+    const int cols = version->map.Cols();
+    auto cellOf = [cols](const Position &pos) { return static_cast<uint64_t>(pos.x) * cols + pos.y; };
+    auto vertexKey = [&](const Position &pos, int time) {
+        return (static_cast<uint64_t>(time) << 32) | cellOf(pos);
+    };
+
+    std::unordered_set<uint64_t> vertexConstraints;
+    std::unordered_set<uint64_t> edgeConstraints;
+    int lastConstraintTime = 0;
+    int minGoalTime = 0;
+    for (const auto &constraint : constraints)
+    {
+        if (constraint.unit != unit)
+        {
+            continue;
+        }
+        lastConstraintTime = std::max(lastConstraintTime, constraint.time);
+        if (constraint.isEdge)
+        {
+            edgeConstraints.insert(vertexKey(constraint.position, constraint.time) * 4 +
+                                   directionOf(constraint.fromPosition, constraint.position));
+        }
+        else
+        {
+            vertexConstraints.insert(vertexKey(constraint.position, constraint.time));
+            if (staysAtTarget && constraint.position == target)
+            {
+                // The unit may only stop for good once nobody needs its target cell anymore
+                minGoalTime = std::max(minGoalTime, constraint.time + 1);
+            }
+        }
+    }
+    // Beyond this horizon every constraint has expired and a static path must have been found
+    const int horizon = lastConstraintTime + rows * cols;
+
+    // Times other units pass the target, each a conflict if the unit stops there before them
+    std::vector<int> targetVisits;
+    if (staysAtTarget)
+    {
+        for (int time = 0; time <= conflicts.lastTime; ++time)
+        {
+            targetVisits.insert(targetVisits.end(),
+                                conflicts.vertices[time * conflicts.cells + cellOf(target)], time);
+        }
+    }
+
+    auto stepConflicts = [&](const Position &from, const Position &to, int time) {
+        const size_t cell = cellOf(to);
+        int count = conflicts.parkedSince[cell] <= time ? 1 : 0;
+        if (time <= conflicts.lastTime)
+        {
+            const size_t index = time * conflicts.cells + cell;
+            count += conflicts.vertices[index];
+            if (!(from == to) && (conflicts.edges[index] >> directionOf(from, to) & 1))
+            {
+                ++count;
+            }
+        }
+        return count;
+    };
+
+    // A finishing node ends the path at the target and carries the conflicts of staying there
+    struct SearchNode
+    {
+        Position pos;
+        int time;
+        int fCost;
+        int conflicts;
+        int parent;
+        bool finishing;
+    };
+    std::vector<SearchNode> nodes;
+    auto fewerConflicts = [&nodes](int a, int b) {
+        if (nodes[a].conflicts != nodes[b].conflicts)
+        {
+            return nodes[a].conflicts < nodes[b].conflicts;
+        }
+        if (nodes[a].fCost != nodes[b].fCost)
+        {
+            return nodes[a].fCost < nodes[b].fCost;
+        }
+        return nodes[a].time != nodes[b].time ? nodes[a].time > nodes[b].time : a < b;
+    };
+    std::set<std::pair<int, int>> openList;
+    std::set<int, decltype(fewerConflicts)> focalList(fewerConflicts);
+    // Best node generated per space-time state. States are reached at a fixed cost, so a node
+    // with fewer conflicts replaces the one found before
+    std::unordered_map<uint64_t, int> bestNodes;
+
+    auto manhattan = [&target](const Position &pos) {
+        return std::abs(pos.x - target.x) + std::abs(pos.y - target.y);
+    };
+    const double factor = m_options.suboptimality;
+    double bound = 0.0;
+    auto push = [&](const SearchNode &node) {
+        if (!node.finishing)
+        {
+            auto [best, inserted] =
+                bestNodes.emplace(vertexKey(node.pos, node.time), static_cast<int>(nodes.size()));
+            if (!inserted)
+            {
+                const int previous = best->second;
+                if (nodes[previous].conflicts <= node.conflicts)
+                {
+                    return;
+                }
+                openList.erase({nodes[previous].fCost, previous});
+                focalList.erase(previous);
+                best->second = static_cast<int>(nodes.size());
+            }
+        }
+        const int index = static_cast<int>(nodes.size());
+        nodes.push_back(node);
+        openList.insert({node.fCost, index});
+        if (node.fCost <= bound)
+        {
+            focalList.insert(index);
+        }
+    };
+
+    bound = manhattan(start) * factor;
+    push({start, 0, manhattan(start), 0, -1, false});
+
+    size_t expansions = 0;
+    while (!openList.empty())
+    {
+        if (++expansions % 1024 == 0 && Clock::now() >= deadline)
+        {
+            return {};
+        }
+
+        // Admit the open nodes the raised lower bound brings within the factor
+        const int minCost = openList.begin()->first;
+        if (minCost * factor > bound)
+        {
+            const double previousBound = bound;
+            bound = minCost * factor;
+            for (auto it = openList.upper_bound({static_cast<int>(previousBound), INT_MAX});
+                 it != openList.end() && it->first <= bound; ++it)
+            {
+                focalList.insert(it->second);
+            }
+        }
+
+        const int currentIndex = *focalList.begin();
+        focalList.erase(focalList.begin());
+        const SearchNode current = nodes[currentIndex];
+        openList.erase({current.fCost, currentIndex});
+
+        if (current.finishing)
+        {
+            auto path = std::make_shared<Path>(current.time + 1);
+            for (int index = currentIndex; index != -1; index = nodes[index].parent)
+            {
+                (*path)[nodes[index].time] = nodes[index].pos;
+            }
+            return {path, minCost};
+        }
+        if (current.pos == target && current.time >= minGoalTime)
+        {
+            const int laterVisits = static_cast<int>(
+                targetVisits.end() -
+                std::upper_bound(targetVisits.begin(), targetVisits.end(), current.time));
+            push({current.pos, current.time, current.fCost, current.conflicts + laterVisits,
+                  currentIndex, true});
+        }
+        if (current.time >= horizon)
+        {
+            continue;
+        }
+
+        const int nextTime = current.time + 1;
+        const Position candidates[] = {{current.pos.x + 1, current.pos.y},
+                                       {current.pos.x - 1, current.pos.y},
+                                       {current.pos.x, current.pos.y + 1},
+                                       {current.pos.x, current.pos.y - 1},
+                                       current.pos};
+        for (const auto &next : candidates)
+        {
+            if (!m_pathFinder.IsTraversable(*version, next) ||
+                (!vertexConstraints.empty() &&
+                 vertexConstraints.count(vertexKey(next, nextTime))) ||
+                (!edgeConstraints.empty() && !(next == current.pos) &&
+                 edgeConstraints.count(vertexKey(next, nextTime) * 4 +
+                                       directionOf(current.pos, next))))
+            {
+                continue;
+            }
+            push({next, nextTime, nextTime + manhattan(next),
+                  current.conflicts + stepConflicts(current.pos, next, nextTime), currentIndex,
+                  false});
+        }
+    }
+    return {};
+}
+
+/**
+ * @brief Scan the paths time step by time step for vertex conflicts (two units in one cell) and edge
+ * conflicts (two units swapping cells)
+ *
+ * @param paths Current path of every unit
+ * @param staysAtTarget Whether each unit keeps occupying its target after arrival
+ * @param conflict Set to the earliest conflict found
+ * @param conflictCount Set to the total number of conflicts
+ *
+ * @return bool true if at least one conflict was found
+ *
+ */
+bool CBSSolver::findFirstConflict(const std::vector<std::shared_ptr<const Path>> &paths,
+                                  const std::vector<bool> &staysAtTarget, Conflict &conflict,
+                                  size_t &conflictCount) const
+{
+    conflictCount = 0;
+    int lastTime = 0;
+    for (const auto &path : paths)
+    {
+        lastTime = std::max(lastTime, static_cast<int>(path->size()));
+    }
+
+    std::unordered_map<Position, size_t> previous, occupied;
+    for (int time = 0; time < lastTime; ++time)
+    {
+        occupied.clear();
+        for (size_t unit = 0; unit < paths.size(); ++unit)
+        {
+            Position pos;
+            if (!positionAt(*paths[unit], time, staysAtTarget[unit], pos))
+            {
+                continue;
+            }
+
+            auto [other, inserted] = occupied.emplace(pos, unit);
+            if (!inserted)
+            {
+                if (conflictCount++ == 0)
+                {
+                    conflict = {other->second, unit, pos, pos, time, false};
+                }
+                continue;
+            }
+
+            // Edge conflict if the unit that was in our new cell moved into our old cell
+            Position from;
+            if (time == 0 || !positionAt(*paths[unit], time - 1, staysAtTarget[unit], from) ||
+                from == pos)
+            {
+                continue;
+            }
+            auto swapped = previous.find(pos);
+            Position otherPos;
+            // Only the lower unit index reports a swap so it is counted once
+            if (swapped != previous.end() && swapped->second > unit &&
+                positionAt(*paths[swapped->second], time, staysAtTarget[swapped->second],
+                           otherPos) &&
+                otherPos == from)
+            {
+                if (conflictCount++ == 0)
+                {
+                    conflict = {unit, swapped->second, from, pos, time, true};
+                }
+            }
+        }
+        previous.swap(occupied);
+    }
+    return conflictCount > 0;
+}
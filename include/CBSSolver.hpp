@@ -0,0 +1,140 @@
+#ifndef CBS_SOLVER_HPP
+#define CBS_SOLVER_HPP
+
+// Local lib includes
+#include "PathFinder.hpp"
+
+// Standard Includes
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace PathPlanner
+{
+// Conflict-Based Search over the unit set of a PathFinder. The high level searches a constraint
+// tree whose nodes are expanded in parallel batches, the low level replans single units with a
+// space-time A* on a thread pool. A suboptimality factor above 1 turns it into Enhanced CBS: both
+// levels keep a focal list of the candidates within the factor of their lower bound and take the
+// one with the fewest conflicts first, the low level counting conflicts with the current paths of
+// the other units.
+class CBSSolver
+{
+  public:
+    using Position = PathFinder::Position;
+    using Path = std::vector<Position>;
+
+    struct Options
+    {
+        // Returned solution costs at most this factor times the optimal sum of path lengths
+        double suboptimality = 1.0;
+        // Worker threads for low level planning, 0 uses the number of hardware threads
+        size_t threadCount = 0;
+        // Constraint tree nodes expanded per batch, 0 uses the thread count
+        size_t batchSize = 0;
+        // Give up after generating this many constraint tree nodes
+        size_t maxNodes = 200000;
+        // Give up once a solve has run this long, 0 for no limit
+        std::chrono::milliseconds timeLimit{0};
+    };
+
+    struct Conflict
+    {
+        size_t firstUnit;
+        size_t secondUnit;
+        Position firstPosition;
+        // Equal to firstPosition for vertex conflicts, the swapped cell for edge conflicts
+        Position secondPosition;
+        int time;
+        bool isEdge;
+    };
+
+    struct Result
+    {
+        bool solved = false;
+        // One path per unit, empty for units whose target is unreachable
+        std::vector<Path> paths;
+        int cost = 0;
+        // Conflicts split on along the constraint tree branch that led to the solution
+        std::vector<Conflict> resolvedConflicts;
+        size_t generatedNodes = 0;
+        size_t expandedNodes = 0;
+        // True if the time limit ended the search
+        bool timedOut = false;
+    };
+
+    // Constructor
+    CBSSolver(const PathFinder &pathFinder, Options options);
+    explicit CBSSolver(const PathFinder &pathFinder) : CBSSolver(pathFinder, Options()) {}
+
+    // Public methods
+    Result Solve() const;
+    Result Solve(const std::vector<Position> &starts, const std::vector<Position> &targets) const;
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Constraint
+    {
+        size_t unit;
+        Position position;
+        // Cell the unit moves from for edge constraints
+        Position fromPosition;
+        int time;
+        bool isEdge;
+    };
+
+    struct TreeNode
+    {
+        std::vector<Constraint> constraints;
+        std::vector<std::shared_ptr<const Path>> paths;
+        // Lower bound on the cost of each unit's path under the node's constraints
+        std::vector<int> lowerBounds;
+        std::vector<Conflict> resolvedConflicts;
+        Conflict firstConflict{};
+        int cost = 0;
+        int lowerBound = 0;
+        size_t conflictCount = 0;
+        // Generation order, keeps the ordering of open nodes deterministic
+        size_t id = 0;
+    };
+
+    // Cells and moves of the current paths of the other units, indexed by time * cells + cell
+    struct ConflictTable
+    {
+        size_t cells = 0;
+        int lastTime = -1;
+        // Units in each cell at each time step up to lastTime
+        std::vector<uint16_t> vertices;
+        // Bit per move direction that would swap cells with a unit
+        std::vector<uint8_t> edges;
+        // Earliest time each cell is held for good by a unit that arrived at its target
+        std::vector<int> parkedSince;
+    };
+
+    struct Plan
+    {
+        // Null if no path exists or the deadline passed
+        std::shared_ptr<const Path> path;
+        int lowerBound = 0;
+    };
+
+    // Private members
+    const PathFinder &m_pathFinder;
+    Options m_options;
+
+    // Private methods
+    Plan planUnit(size_t unit, const Position &start, const Position &target,
+                  const std::vector<Constraint> &constraints, const ConflictTable &conflicts,
+                  bool staysAtTarget, Clock::time_point deadline) const;
+    ConflictTable buildConflictTable(const std::vector<std::shared_ptr<const Path>> &paths,
+                                     const std::vector<bool> &staysAtTarget, size_t skipUnit) const;
+    void evaluateNode(TreeNode &node, const std::vector<bool> &staysAtTarget) const;
+    bool findFirstConflict(const std::vector<std::shared_ptr<const Path>> &paths,
+                           const std::vector<bool> &staysAtTarget, Conflict &conflict,
+                           size_t &conflictCount) const;
+};
+} // namespace PathPlanner
+
+#endif // CBS_SOLVER_HPP
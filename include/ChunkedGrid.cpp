@@ -0,0 +1,562 @@
+// Local lib includes
+#include "ChunkedGrid.hpp"
+
+// Standard Includes
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <unordered_set>
+using namespace PathPlanner;
+
+namespace
+{
+// Chunk file layout: magic, dimensions, markers, chunk table and the raw chunk payloads
+const char ChunkFileMagic[8] = {'R', 'T', 'S', 'C', 'H', 'N', 'K', '1'};
+enum ChunkKind : uint8_t
+{
+    UniformChunk = 0,
+    RawChunk = 1
+};
+
+template <typename T> void writeValue(std::ostream &stream, const T &value)
+{
+    stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T> T readValue(std::istream &stream)
+{
+    T value{};
+    stream.read(reinterpret_cast<char *>(&value), sizeof(T));
+    if (!stream)
+    {
+        throw std::runtime_error("Unexpected end of chunk data");
+    }
+    return value;
+}
+} // namespace
+
+/**
+ * @brief Construct a grid of the given dimensions with every cell set to the same value. All chunks
+ * share one immutable uniform chunk
+ *
+ * @param rows,cols Dimensions of the grid
+ * @param fillValue Terrain value for all cells
+ * @param chunkSize Edge length of the square chunks
+ *
+ */
+ChunkedGrid::ChunkedGrid(int rows, int cols, int fillValue, int chunkSize)
+{
+    allocateChunkTable(rows, cols, chunkSize);
+    std::fill(m_chunks.begin(), m_chunks.end(), uniformChunk(fillValue, m_chunkSize));
+}
+
+/**
+ * @brief Construct a grid from row major cell data. Chunks whose cells all hold the same value are
+ * replaced by the shared uniform chunk for that value
+ *
+ * @param rows,cols Dimensions of the grid
+ * @param cells Row major terrain values, expected to hold rows * cols entries
+ * @param chunkSize Edge length of the square chunks
+ *
+ */
+ChunkedGrid::ChunkedGrid(int rows, int cols, const std::vector<int> &cells, int chunkSize)
+{
+    if (cells.size() != static_cast<size_t>(rows) * static_cast<size_t>(cols))
+    {
+        throw std::invalid_argument("Cell data does not match the grid dimensions");
+    }
+    allocateChunkTable(rows, cols, chunkSize);
+
+    for (size_t index = 0; index < m_chunks.size(); ++index)
+    {
+        int originX = static_cast<int>(index / m_chunkCols) * m_chunkSize;
+        int originY = static_cast<int>(index % m_chunkCols) * m_chunkSize;
+        int firstValue = cells[static_cast<size_t>(originX) * cols + originY];
+
+        // Cells beyond the grid edge are padded with the first value so edge chunks can be uniform
+        auto chunk = std::make_shared<Chunk>();
+        chunk->cells.assign(static_cast<size_t>(m_chunkSize) * m_chunkSize, firstValue);
+        bool uniform = true;
+        for (int x = originX; x < std::min(originX + m_chunkSize, rows); ++x)
+        {
+            for (int y = originY; y < std::min(originY + m_chunkSize, cols); ++y)
+            {
+                int value = cells[static_cast<size_t>(x) * cols + y];
+                chunk->cells[(x - originX) * m_chunkSize + (y - originY)] = value;
+                uniform = uniform && value == firstValue;
+            }
+        }
+        m_chunks[index] = uniform ? uniformChunk(firstValue, m_chunkSize) : std::move(chunk);
+    }
+}
+
+/**
+ * @brief Open a chunk file previously written by WriteChunkFile. Only the chunk table is read, raw
+ * chunks are decoded on first access and evicted in least recently used order once the resident
+ * size exceeds the memory limit
+ *
+ * @param filePath Path to the chunk file
+ * @param memoryLimitBytes Upper bound for decoded chunks kept in memory, 0 for no limit
+ * @param markers Optional output for the marker cells stored in the file
+ *
+ * @return ChunkedGrid backed by the chunk file
+ *
+ */
+ChunkedGrid ChunkedGrid::OpenChunkFile(const std::string &filePath, size_t memoryLimitBytes,
+                                       std::vector<Marker> *markers)
+{
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cerr << "Chunk file error at file: " << __FILE__ << ", line: " << __LINE__
+                  << std::endl;
+        throw std::runtime_error("Failed to open chunk file: " + filePath);
+    }
+
+    char magic[sizeof(ChunkFileMagic)];
+    file.read(magic, sizeof(magic));
+    if (!file || std::memcmp(magic, ChunkFileMagic, sizeof(magic)) != 0)
+    {
+        std::cerr << "Chunk file error at file: " << __FILE__ << ", line: " << __LINE__
+                  << std::endl;
+        throw std::runtime_error("Invalid chunk file header: " + filePath);
+    }
+
+    ChunkedGrid grid;
+    int rows = readValue<int32_t>(file);
+    int cols = readValue<int32_t>(file);
+    int chunkSize = readValue<int32_t>(file);
+    if (rows < 0 || cols < 0 || chunkSize <= 0)
+    {
+        throw std::runtime_error("Invalid chunk file dimensions: " + filePath);
+    }
+    grid.allocateChunkTable(rows, cols, chunkSize);
+
+    uint32_t markerCount = readValue<uint32_t>(file);
+    for (uint32_t i = 0; i < markerCount; ++i)
+    {
+        Marker marker;
+        marker.value = readValue<int32_t>(file);
+        marker.x = readValue<int32_t>(file);
+        marker.y = readValue<int32_t>(file);
+        if (markers)
+        {
+            markers->push_back(marker);
+        }
+    }
+
+    // Uniform chunks are resolved right away, raw chunks are left to the lazy source
+    std::vector<uint64_t> offsets(grid.m_chunks.size(), 0);
+    for (size_t index = 0; index < grid.m_chunks.size(); ++index)
+    {
+        uint8_t kind = readValue<uint8_t>(file);
+        int32_t value = readValue<int32_t>(file);
+        uint64_t offset = readValue<uint64_t>(file);
+        if (kind == UniformChunk)
+        {
+            grid.m_chunks[index] = uniformChunk(value, chunkSize);
+        }
+        else
+        {
+            offsets[index] = offset;
+        }
+    }
+
+    grid.m_source =
+        std::make_shared<ChunkSource>(filePath, memoryLimitBytes, chunkSize, std::move(offsets));
+    return grid;
+}
+
+/**
+ * @brief Write the grid to a chunk file. Uniform chunks are stored as a single value, all other
+ * chunks as raw cell data
+ *
+ * @param filePath Destination path
+ * @param markers Cells to record in the marker section, in the order they should be read back
+ *
+ */
+void ChunkedGrid::WriteChunkFile(const std::string &filePath,
+                                 const std::vector<Marker> &markers) const
+{
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::cerr << "Chunk file error at file: " << __FILE__ << ", line: " << __LINE__
+                  << std::endl;
+        throw std::runtime_error("Failed to open chunk file for writing: " + filePath);
+    }
+
+    file.write(ChunkFileMagic, sizeof(ChunkFileMagic));
+    writeValue<int32_t>(file, m_rows);
+    writeValue<int32_t>(file, m_cols);
+    writeValue<int32_t>(file, m_chunkSize);
+    writeValue<uint32_t>(file, static_cast<uint32_t>(markers.size()));
+    for (const auto &marker : markers)
+    {
+        writeValue<int32_t>(file, marker.value);
+        writeValue<int32_t>(file, marker.x);
+        writeValue<int32_t>(file, marker.y);
+    }
+
+    const size_t tableEntryBytes = sizeof(uint8_t) + sizeof(int32_t) + sizeof(uint64_t);
+    const size_t chunkBytes = static_cast<size_t>(m_chunkSize) * m_chunkSize * sizeof(int32_t);
+    uint64_t nextOffset = static_cast<uint64_t>(file.tellp()) + tableEntryBytes * m_chunks.size();
+
+    std::vector<std::shared_ptr<const Chunk>> rawChunks;
+    for (size_t index = 0; index < m_chunks.size(); ++index)
+    {
+        std::shared_ptr<const Chunk> pin;
+        const Chunk &chunk = chunkAt(index, pin);
+        if (chunk.uniform)
+        {
+            writeValue<uint8_t>(file, UniformChunk);
+            writeValue<int32_t>(file, chunk.cells.front());
+            writeValue<uint64_t>(file, 0);
+        }
+        else
+        {
+            writeValue<uint8_t>(file, RawChunk);
+            writeValue<int32_t>(file, 0);
+            writeValue<uint64_t>(file, nextOffset);
+            nextOffset += chunkBytes;
+            rawChunks.push_back(pin ? pin : m_chunks[index]);
+        }
+    }
+
+    for (const auto &chunk : rawChunks)
+    {
+        for (int value : chunk->cells)
+        {
+            writeValue<int32_t>(file, value);
+        }
+    }
+}
+
+/**
+ * @brief Write the complete grid to a stream. Unlike a chunk file every chunk is stored inline, so
+ * Deserialize restores a fully resident grid with a single sequential read
+ *
+ * @param stream Binary output stream
+ *
+ */
+void ChunkedGrid::Serialize(std::ostream &stream) const
+{
+    writeValue<int32_t>(stream, m_rows);
+    writeValue<int32_t>(stream, m_cols);
+    writeValue<int32_t>(stream, m_chunkSize);
+    for (size_t index = 0; index < m_chunks.size(); ++index)
+    {
+        std::shared_ptr<const Chunk> pin;
+        const Chunk &chunk = chunkAt(index, pin);
+        writeValue<uint8_t>(stream, chunk.uniform ? UniformChunk : RawChunk);
+        if (chunk.uniform)
+        {
+            writeValue<int32_t>(stream, chunk.cells.front());
+        }
+        else
+        {
+            stream.write(reinterpret_cast<const char *>(chunk.cells.data()),
+                         static_cast<std::streamsize>(chunk.cells.size() * sizeof(int)));
+        }
+    }
+}
+
+/**
+ * @brief Restore a grid written by Serialize. Uniform chunks are shared again
+ *
+ * @param stream Binary input stream positioned at the serialized grid
+ *
+ * @return ChunkedGrid with every chunk resident
+ *
+ */
+ChunkedGrid ChunkedGrid::Deserialize(std::istream &stream)
+{
+    ChunkedGrid grid;
+    int rows = readValue<int32_t>(stream);
+    int cols = readValue<int32_t>(stream);
+    int chunkSize = readValue<int32_t>(stream);
+    grid.allocateChunkTable(rows, cols, chunkSize);
+
+    for (auto &entry : grid.m_chunks)
+    {
+        if (readValue<uint8_t>(stream) == UniformChunk)
+        {
+            entry = uniformChunk(readValue<int32_t>(stream), chunkSize);
+            continue;
+        }
+        auto chunk = std::make_shared<Chunk>();
+        chunk->cells.resize(static_cast<size_t>(chunkSize) * chunkSize);
+        stream.read(reinterpret_cast<char *>(chunk->cells.data()),
+                    static_cast<std::streamsize>(chunk->cells.size() * sizeof(int)));
+        if (!stream)
+        {
+            throw std::runtime_error("Unexpected end of chunk data");
+        }
+        entry = std::move(chunk);
+    }
+    return grid;
+}
+
+/**
+ * @brief Access the terrain value of a cell. Decodes the containing chunk if it is not resident
+ *
+ * @param x,y Row and column of the cell
+ *
+ * @return int terrain value of the cell
+ *
+ */
+int ChunkedGrid::At(int x, int y) const
+{
+    if (x < 0 || x >= m_rows || y < 0 || y >= m_cols)
+    {
+        throw std::out_of_range("Grid position out of bounds");
+    }
+    std::shared_ptr<const Chunk> pin;
+    const Chunk &chunk = chunkAt(chunkIndex(x, y), pin);
+    return chunk.cells[(x % m_chunkSize) * m_chunkSize + (y % m_chunkSize)];
+}
+
+/**
+ * @brief Change the terrain value of a cell. The containing chunk is copied first unless this grid
+ * is its only owner, so shared uniform chunks, lazily loaded chunks and copies of the grid are
+ * never modified. A changed chunk stays resident for the lifetime of the grid
+ *
+ * @param x,y Row and column of the cell
+ * @param value New terrain value
+ *
+ */
+void ChunkedGrid::Set(int x, int y, int value)
+{
+    if (x < 0 || x >= m_rows || y < 0 || y >= m_cols)
+    {
+        throw std::out_of_range("Grid position out of bounds");
+    }
+    const size_t index = chunkIndex(x, y);
+    const size_t cell = static_cast<size_t>(x % m_chunkSize) * m_chunkSize + (y % m_chunkSize);
+    std::shared_ptr<const Chunk> pin;
+    const Chunk &chunk = chunkAt(index, pin);
+    if (chunk.cells[cell] == value)
+    {
+        return;
+    }
+    if (!pin && !chunk.uniform && m_chunks[index].use_count() == 1)
+    {
+        // Chunks are always allocated non const, so writing through the sole owner is safe
+        const_cast<Chunk &>(chunk).cells[cell] = value;
+        return;
+    }
+    auto copy = std::make_shared<Chunk>(chunk);
+    copy->uniform = false;
+    copy->cells[cell] = value;
+    m_chunks[index] = std::move(copy);
+}
+
+/**
+ * @brief Estimate the memory held by decoded chunks. Shared uniform chunks are counted once
+ *
+ * @return size_t number of bytes used by chunk cell data
+ *
+ */
+size_t ChunkedGrid::ResidentBytes() const
+{
+    std::unordered_set<const Chunk *> counted;
+    size_t bytes = 0;
+    for (const auto &chunk : m_chunks)
+    {
+        if (chunk && counted.insert(chunk.get()).second)
+        {
+            bytes += chunk->cells.size() * sizeof(int);
+        }
+    }
+    return bytes + (m_source ? m_source->ResidentBytes() : 0);
+}
+
+/**
+ * @brief Size the chunk table for the given dimensions
+ *
+ */
+void ChunkedGrid::allocateChunkTable(int rows, int cols, int chunkSize)
+{
+    if (rows < 0 || cols < 0 || chunkSize <= 0)
+    {
+        throw std::invalid_argument("Invalid grid dimensions");
+    }
+    m_rows = rows;
+    m_cols = cols;
+    m_chunkSize = chunkSize;
+    m_chunkCols = (cols + chunkSize - 1) / chunkSize;
+    int chunkRows = (rows + chunkSize - 1) / chunkSize;
+    m_chunks.assign(static_cast<size_t>(chunkRows) * m_chunkCols, nullptr);
+}
+
+/**
+ * @brief Index into the chunk table for the chunk containing a cell
+ *
+ */
+size_t ChunkedGrid::chunkIndex(int x, int y) const
+{
+    return static_cast<size_t>(x / m_chunkSize) * m_chunkCols + (y / m_chunkSize);
+}
+
+/**
+ * @brief Resolve a chunk from the table, falling back to the lazy chunk source. Chunks obtained from
+ * the source are held by the pin so they stay valid even if evicted concurrently
+ *
+ * @param index Index into the chunk table
+ * @param pin Holds a reference to lazily loaded chunks for the lifetime of the caller's access
+ *
+ * @return const Chunk& the resolved chunk
+ *
+ */
+const ChunkedGrid::Chunk &ChunkedGrid::chunkAt(size_t index,
+                                               std::shared_ptr<const Chunk> &pin) const
+{
+    const auto &resident = m_chunks[index];
+    if (resident)
+    {
+        return *resident;
+    }
+    pin = m_source->Fetch(index);
+    return *pin;
+}
+
+/**
+ * @brief Number of uniform chunks alive in the process wide cache, i.e. still used by some grid
+ *
+ */
+size_t ChunkedGrid::UniformChunkCount()
+{
+    auto &[cacheMutex, cache] = uniformCache();
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return std::count_if(cache.begin(), cache.end(),
+                         [](const auto &entry) { return !entry.second.expired(); });
+}
+
+/**
+ * @brief Process wide cache of uniform chunks by value and chunk size
+ *
+ */
+ChunkedGrid::UniformCache &ChunkedGrid::uniformCache()
+{
+    static UniformCache cache;
+    return cache;
+}
+
+/**
+ * @brief Obtain the shared immutable chunk used for regions where every cell has the same value.
+ * The cache only holds weak references, so a uniform chunk is freed with the last grid using it,
+ * e.g. the label and clearance chunks of a dropped map version
+ *
+ * @param value Cell value of the uniform region
+ * @param chunkSize Edge length of the chunk
+ *
+ * @return shared pointer to the uniform chunk
+ *
+ */
+std::shared_ptr<const ChunkedGrid::Chunk> ChunkedGrid::uniformChunk(int value, int chunkSize)
+{
+    auto &[cacheMutex, cache] = uniformCache();
+    // Expired entries are swept whenever the cache doubled since the last sweep
+    static size_t sweepSize = 64;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto &entry = cache[{value, chunkSize}];
+    std::shared_ptr<const Chunk> chunk = entry.lock();
+    if (!chunk)
+    {
+        auto uniform = std::make_shared<Chunk>();
+        uniform->cells.assign(static_cast<size_t>(chunkSize) * chunkSize, value);
+        uniform->uniform = true;
+        chunk = std::move(uniform);
+        entry = chunk;
+    }
+    if (cache.size() >= sweepSize)
+    {
+        for (auto it = cache.begin(); it != cache.end();)
+        {
+            it = it->second.expired() ? cache.erase(it) : std::next(it);
+        }
+        sweepSize = std::max<size_t>(64, cache.size() * 2);
+    }
+    return chunk;
+}
+
+/**
+ * @brief Constructor for the lazy chunk source of a chunk file
+ *
+ * @param filePath Chunk file to decode raw chunks from
+ * @param memoryLimitBytes Upper bound for resident decoded chunks, 0 for no limit
+ * @param chunkSize Edge length of the chunks
+ * @param offsets File offset of each raw chunk, indexed like the chunk table
+ *
+ */
+ChunkedGrid::ChunkSource::ChunkSource(const std::string &filePath, size_t memoryLimitBytes,
+                                      int chunkSize, std::vector<uint64_t> offsets)
+    : m_filePath(filePath), m_memoryLimitBytes(memoryLimitBytes),
+      m_chunkBytes(static_cast<size_t>(chunkSize) * chunkSize * sizeof(int)),
+      m_offsets(std::move(offsets))
+{
+}
+
+/**
+ * @brief Return a decoded chunk, reading it from disk if it is not resident. Least recently used
+ * chunks are evicted while the resident size is above the memory limit
+ *
+ * @param chunkIndex Index into the chunk table
+ *
+ * @return shared pointer to the decoded chunk
+ *
+ */
+std::shared_ptr<const ChunkedGrid::Chunk> ChunkedGrid::ChunkSource::Fetch(size_t chunkIndex)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto found = m_resident.find(chunkIndex);
+    if (found != m_resident.end())
+    {
+        m_lruOrder.splice(m_lruOrder.begin(), m_lruOrder, found->second.second);
+        return found->second.first;
+    }
+
+    std::ifstream file(m_filePath, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cerr << "Chunk file error at file: " << __FILE__ << ", line: " << __LINE__
+                  << std::endl;
+        throw std::runtime_error("Failed to reopen chunk file: " + m_filePath);
+    }
+    file.seekg(static_cast<std::streamoff>(m_offsets[chunkIndex]));
+
+    auto chunk = std::make_shared<Chunk>();
+    chunk->cells.resize(m_chunkBytes / sizeof(int));
+    for (auto &value : chunk->cells)
+    {
+        value = readValue<int32_t>(file);
+    }
+
+    m_lruOrder.push_front(chunkIndex);
+    m_resident[chunkIndex] = {chunk, m_lruOrder.begin()};
+
+    // Never evict the chunk that was just requested
+    while (m_memoryLimitBytes > 0 && m_resident.size() > 1 &&
+           m_resident.size() * m_chunkBytes > m_memoryLimitBytes)
+    {
+        m_resident.erase(m_lruOrder.back());
+        m_lruOrder.pop_back();
+    }
+    return chunk;
+}
+
+/**
+ * @brief Number of bytes held by decoded chunks of this source
+ *
+ */
+size_t ChunkedGrid::ChunkSource::ResidentBytes() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_resident.size() * m_chunkBytes;
+}
@@ -0,0 +1,126 @@
+#ifndef CHUNKED_GRID_HPP
+#define CHUNKED_GRID_HPP
+
+// Standard Includes
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace PathPlanner
+{
+// Sparse 2D terrain grid split into fixed size square chunks. Chunks whose cells all carry the
+// same terrain value share a single immutable instance, and grids opened from a chunk file decode
+// their chunks lazily on first access and may evict them again once a memory cap is exceeded.
+class ChunkedGrid
+{
+  public:
+    static constexpr int DefaultChunkSize = 64;
+
+    struct Chunk
+    {
+        std::vector<int> cells;
+        bool uniform = false;
+    };
+
+    // Cell recorded in the marker section of a chunk file, e.g. a unit start or target
+    struct Marker
+    {
+        int value;
+        int x;
+        int y;
+    };
+
+    // Read-only view of a single row, allowing grid[x][y] style access
+    class RowView
+    {
+      public:
+        RowView(const ChunkedGrid &grid, int row) : m_grid(grid), m_row(row) {}
+        int operator[](int col) const { return m_grid.At(m_row, col); }
+        size_t size() const { return static_cast<size_t>(m_grid.Cols()); }
+
+      private:
+        const ChunkedGrid &m_grid;
+        int m_row;
+    };
+
+    // Constructors
+    ChunkedGrid() = default;
+    ChunkedGrid(int rows, int cols, int fillValue, int chunkSize = DefaultChunkSize);
+    ChunkedGrid(int rows, int cols, const std::vector<int> &cells,
+                int chunkSize = DefaultChunkSize);
+
+    // Open a chunk file written by WriteChunkFile. Chunks are decoded on first access
+    static ChunkedGrid OpenChunkFile(const std::string &filePath, size_t memoryLimitBytes = 0,
+                                     std::vector<Marker> *markers = nullptr);
+
+    // Public methods
+    int At(int x, int y) const;
+    void Set(int x, int y, int value);
+    int Rows() const { return m_rows; }
+    int Cols() const { return m_cols; }
+    int ChunkSize() const { return m_chunkSize; }
+    bool Empty() const { return m_rows == 0 || m_cols == 0; }
+    size_t ResidentBytes() const;
+    size_t ChunkCount() const { return m_chunks.size(); }
+    void WriteChunkFile(const std::string &filePath, const std::vector<Marker> &markers = {}) const;
+    void Serialize(std::ostream &stream) const;
+    static ChunkedGrid Deserialize(std::istream &stream);
+    static size_t UniformChunkCount();
+
+    // Vector of vectors compatible accessors
+    size_t size() const { return static_cast<size_t>(m_rows); }
+    RowView operator[](int row) const { return RowView(*this, row); }
+
+  private:
+    // Lazily decoded backing store for grids opened from a chunk file
+    class ChunkSource
+    {
+      public:
+        ChunkSource(const std::string &filePath, size_t memoryLimitBytes, int chunkSize,
+                    std::vector<uint64_t> offsets);
+        std::shared_ptr<const Chunk> Fetch(size_t chunkIndex);
+        size_t ResidentBytes() const;
+
+      private:
+        std::string m_filePath;
+        size_t m_memoryLimitBytes;
+        size_t m_chunkBytes;
+        std::vector<uint64_t> m_offsets;
+        std::list<size_t> m_lruOrder;
+        std::unordered_map<size_t, std::pair<std::shared_ptr<const Chunk>, std::list<size_t>::iterator>>
+            m_resident;
+        mutable std::mutex m_mutex;
+    };
+
+    // Private members
+    int m_rows = 0;
+    int m_cols = 0;
+    int m_chunkSize = DefaultChunkSize;
+    int m_chunkCols = 0;
+    std::vector<std::shared_ptr<const Chunk>> m_chunks;
+    std::shared_ptr<ChunkSource> m_source;
+
+    // Private methods
+    void allocateChunkTable(int rows, int cols, int chunkSize);
+    size_t chunkIndex(int x, int y) const;
+    const Chunk &chunkAt(size_t index, std::shared_ptr<const Chunk> &pin) const;
+    // Uniform chunks are only weakly referenced, so they live as long as a grid uses them
+    struct UniformCache
+    {
+        std::mutex mutex;
+        std::map<std::pair<int, int>, std::weak_ptr<const Chunk>> chunks;
+    };
+    static UniformCache &uniformCache();
+    static std::shared_ptr<const Chunk> uniformChunk(int value, int chunkSize);
+};
+} // namespace PathPlanner
+
+#endif // CHUNKED_GRID_HPP
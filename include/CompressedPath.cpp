@@ -0,0 +1,216 @@
+// Local lib includes
+#include "CompressedPath.hpp"
+
+// Standard Includes
+#include <cstdlib>
+#include <stdexcept>
+using namespace PathPlanner;
+using Position = PathPlanner::PathFinder::Position;
+
+/**
+ * @brief Compress a path given cell by cell
+ *
+ * @param cells Consecutive cells of the path, each adjacent or diagonally adjacent to the previous
+ * one
+ *
+ */
+CompressedPath::CompressedPath(const std::vector<Position> &cells)
+{
+    if (cells.empty())
+    {
+        return;
+    }
+    m_start = cells.front();
+    m_target = cells.back();
+    m_size = cells.size();
+
+    uint32_t length = 0;
+    Direction direction = Direction::Down;
+    for (size_t i = 1; i < cells.size(); ++i)
+    {
+        const Direction step = DirectionBetween(cells[i - 1], cells[i]);
+        if (length != 0 && (step != direction || length == MaxRunLength))
+        {
+            m_runs.push_back(packRun(direction, length));
+            length = 0;
+        }
+        direction = step;
+        ++length;
+    }
+    if (length != 0)
+    {
+        m_runs.push_back(packRun(direction, length));
+    }
+}
+
+/**
+ * @brief Decode one run of the path
+ *
+ * @param index Run index, starting at the start cell
+ *
+ * @return Run with its direction and number of moves
+ *
+ */
+CompressedPath::Run CompressedPath::GetRun(size_t index) const
+{
+    const uint32_t packed = m_runs.at(index);
+    return {static_cast<Direction>(packed & ((1u << DirectionBits) - 1)), packed >> DirectionBits};
+}
+
+/**
+ * @brief Corner cells of the path, i.e. the start, every cell where the direction changes and
+ * the target. Units can steer from one waypoint to the next in a straight line
+ *
+ * @return vector<Position> waypoints in path order, empty for an empty path
+ *
+ */
+std::vector<Position> CompressedPath::Waypoints() const
+{
+    std::vector<Position> waypoints;
+    if (Empty())
+    {
+        return waypoints;
+    }
+    waypoints.reserve(m_runs.size() + 1);
+    waypoints.push_back(m_start);
+    for (size_t i = 0; i < m_runs.size(); ++i)
+    {
+        const Run run = GetRun(i);
+        waypoints.push_back(Step(waypoints.back(), run.direction, static_cast<int>(run.length)));
+    }
+    return waypoints;
+}
+
+/**
+ * @brief Expand the path into one entry per cell
+ *
+ * @return vector<Position> cells from start to target
+ *
+ */
+std::vector<Position> CompressedPath::Expand() const
+{
+    return std::vector<Position>(begin(), end());
+}
+
+/**
+ * @brief Iterator at the start cell
+ *
+ */
+CompressedPath::Iterator CompressedPath::begin() const
+{
+    Iterator it;
+    it.m_path = this;
+    it.m_pos = m_start;
+    return it;
+}
+
+/**
+ * @brief Iterator past the target cell
+ *
+ */
+CompressedPath::Iterator CompressedPath::end() const
+{
+    Iterator it;
+    it.m_path = this;
+    it.m_index = m_size;
+    return it;
+}
+
+/**
+ * @brief Move to the next cell of the path
+ *
+ */
+CompressedPath::Iterator &CompressedPath::Iterator::operator++()
+{
+    ++m_index;
+    if (m_run < m_path->m_runs.size())
+    {
+        const Run run = m_path->GetRun(m_run);
+        m_pos = Step(m_pos, run.direction);
+        if (++m_step == run.length)
+        {
+            ++m_run;
+            m_step = 0;
+        }
+    }
+    return *this;
+}
+
+/**
+ * @brief Paths are equal when they visit the same cells in the same order
+ *
+ */
+bool CompressedPath::operator==(const CompressedPath &other) const
+{
+    if (m_size != other.m_size)
+    {
+        return false;
+    }
+    return m_size == 0 || (m_start == other.m_start && m_runs == other.m_runs);
+}
+
+/**
+ * @brief Direction of a single move between two adjacent or diagonally adjacent cells
+ *
+ * @param from,to Cells of the move
+ *
+ * @return Direction from from to to. Throws std::invalid_argument if the cells are not neighbors
+ *
+ */
+CompressedPath::Direction CompressedPath::DirectionBetween(const Position &from,
+                                                           const Position &to)
+{
+    const int dx = to.x - from.x;
+    const int dy = to.y - from.y;
+    if (std::abs(dx) > 1 || std::abs(dy) > 1 || (dx == 0 && dy == 0))
+    {
+        throw std::invalid_argument("Consecutive path cells must be neighbors");
+    }
+    if (dy == 0)
+    {
+        return dx > 0 ? Direction::Down : Direction::Up;
+    }
+    if (dx == 0)
+    {
+        return dy > 0 ? Direction::Right : Direction::Left;
+    }
+    if (dx > 0)
+    {
+        return dy > 0 ? Direction::DownRight : Direction::DownLeft;
+    }
+    return dy > 0 ? Direction::UpRight : Direction::UpLeft;
+}
+
+/**
+ * @brief Move a position along a direction
+ *
+ * @param pos Position to move from
+ * @param direction Direction to move in
+ * @param count Number of moves
+ *
+ * @return Position reached
+ *
+ */
+Position CompressedPath::Step(const Position &pos, Direction direction, int count)
+{
+    switch (direction)
+    {
+    case Direction::Down:
+        return {pos.x + count, pos.y};
+    case Direction::Up:
+        return {pos.x - count, pos.y};
+    case Direction::Right:
+        return {pos.x, pos.y + count};
+    case Direction::Left:
+        return {pos.x, pos.y - count};
+    case Direction::DownRight:
+        return {pos.x + count, pos.y + count};
+    case Direction::DownLeft:
+        return {pos.x + count, pos.y - count};
+    case Direction::UpRight:
+        return {pos.x - count, pos.y + count};
+    case Direction::UpLeft:
+        return {pos.x - count, pos.y - count};
+    }
+    return pos;
+}
@@ -0,0 +1,182 @@
+#ifndef COMPRESSED_PATH_HPP
+#define COMPRESSED_PATH_HPP
+
+// Local lib includes
+#include "PathFinder.hpp"
+
+// Standard Includes
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace PathPlanner
+{
+// Path stored as its start cell and run length encoded moves. A straight or diagonal stretch of any
+// length takes four bytes, so memory grows with the number of turns instead of the number of cells.
+// The cells are expanded lazily by iterating, and the waypoints are the corners where the direction
+// changes.
+class CompressedPath
+{
+  public:
+    using Position = PathFinder::Position;
+
+    enum class Direction : uint8_t
+    {
+        Down = 0,  // x + 1
+        Up = 1,    // x - 1
+        Right = 2, // y + 1
+        Left = 3,  // y - 1
+        // Diagonal moves of searches with QueryOptions::allowDiagonal
+        DownRight = 4,
+        DownLeft = 5,
+        UpRight = 6,
+        UpLeft = 7,
+    };
+
+    // Stretch of a path in one direction, length counts moves
+    struct Run
+    {
+        Direction direction;
+        uint32_t length;
+    };
+
+    // Forward iterator producing the cells of a path one by one
+    class Iterator
+    {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Position;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Position *;
+        using reference = const Position &;
+
+        Iterator() = default;
+
+        reference operator*() const { return m_pos; }
+        pointer operator->() const { return &m_pos; }
+        Iterator &operator++();
+        Iterator operator++(int)
+        {
+            Iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+        bool operator==(const Iterator &other) const { return m_index == other.m_index; }
+        bool operator!=(const Iterator &other) const { return m_index != other.m_index; }
+
+      private:
+        friend class CompressedPath;
+
+        const CompressedPath *m_path = nullptr;
+        Position m_pos;
+        size_t m_run = 0;
+        uint32_t m_step = 0;
+        size_t m_index = 0;
+    };
+
+    // Constructors
+    CompressedPath() = default;
+    explicit CompressedPath(const std::vector<Position> &cells);
+
+    // Build from search nodes linked from the target back to the start, see FromParentChain
+    template <typename NodeType> static CompressedPath FromParentChain(const NodeType *target);
+
+    // Public methods
+    bool Empty() const { return m_size == 0; }
+    size_t Size() const { return m_size; }
+    Position Start() const { return m_start; }
+    Position Target() const { return m_target; }
+    size_t RunCount() const { return m_runs.size(); }
+    Run GetRun(size_t index) const;
+    std::vector<Position> Waypoints() const;
+    std::vector<Position> Expand() const;
+    size_t MemoryUsage() const { return sizeof(*this) + m_runs.capacity() * sizeof(uint32_t); }
+    Iterator begin() const;
+    Iterator end() const;
+    bool operator==(const CompressedPath &other) const;
+
+    static Direction DirectionBetween(const Position &from, const Position &to);
+    static Position Step(const Position &pos, Direction direction, int count = 1);
+
+  private:
+    // Runs are packed with the direction in the low bits and the length above it
+    static constexpr uint32_t DirectionBits = 3;
+    static constexpr uint32_t MaxRunLength = UINT32_MAX >> DirectionBits;
+
+    // Private members
+    Position m_start;
+    Position m_target;
+    // Number of cells including start and target
+    size_t m_size = 0;
+    std::vector<uint32_t> m_runs;
+
+    // Private methods
+    static uint32_t packRun(Direction direction, uint32_t length)
+    {
+        return (length << DirectionBits) | static_cast<uint32_t>(direction);
+    }
+};
+
+/**
+ * @brief Compress the path ending at a search node by following its parent pointers. The chain is
+ * walked twice, once to count the runs and once to write them back to front, so the path is built
+ * in order without a reverse pass or any reallocation
+ *
+ * @param target Search node of the target, nullptr for an empty path. NodeType needs pos and
+ * parent members
+ *
+ * @return CompressedPath from the first node of the chain to target
+ *
+ */
+template <typename NodeType> CompressedPath CompressedPath::FromParentChain(const NodeType *target)
+{
+    CompressedPath path;
+    if (target == nullptr)
+    {
+        return path;
+    }
+
+    size_t runCount = 0;
+    uint32_t length = 0;
+    Direction direction = Direction::Down;
+    const NodeType *node = target;
+    for (; node->parent != nullptr; node = node->parent)
+    {
+        const Direction step = DirectionBetween(node->parent->pos, node->pos);
+        if (length == 0 || step != direction || length == MaxRunLength)
+        {
+            ++runCount;
+            length = 0;
+        }
+        direction = step;
+        ++length;
+        ++path.m_size;
+    }
+    path.m_start = node->pos;
+    path.m_target = target->pos;
+    ++path.m_size;
+
+    path.m_runs.resize(runCount);
+    size_t run = runCount;
+    length = 0;
+    for (node = target; node->parent != nullptr; node = node->parent)
+    {
+        const Direction step = DirectionBetween(node->parent->pos, node->pos);
+        if (length != 0 && (step != direction || length == MaxRunLength))
+        {
+            path.m_runs[--run] = packRun(direction, length);
+            length = 0;
+        }
+        direction = step;
+        ++length;
+    }
+    if (length != 0)
+    {
+        path.m_runs[--run] = packRun(direction, length);
+    }
+    return path;
+}
+} // namespace PathPlanner
+
+#endif // COMPRESSED_PATH_HPP
@@ -0,0 +1,571 @@
+// Local lib includes
+#include "ContractionHierarchy.hpp"
+#include "Tracer.hpp"
+
+// Standard Includes
+#include <algorithm>
+#include <functional>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <queue>
+#include <stdexcept>
+#include <unordered_map>
+using namespace PathPlanner;
+using Position = PathPlanner::PathFinder::Position;
+
+namespace
+{
+constexpr int32_t Unreachable = std::numeric_limits<int32_t>::max();
+// Nodes settled by a witness search before it gives up and keeps the shortcut
+constexpr int WitnessSettleLimit = 256;
+
+template <typename T> void writeValue(std::ostream &stream, const T &value)
+{
+    stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T> T readValue(std::istream &stream)
+{
+    T value{};
+    stream.read(reinterpret_cast<char *>(&value), sizeof(T));
+    if (!stream)
+    {
+        throw std::runtime_error("Unexpected end of contraction hierarchy data");
+    }
+    return value;
+}
+
+template <typename T> void writeVector(std::ostream &stream, const std::vector<T> &values)
+{
+    writeValue<uint64_t>(stream, values.size());
+    stream.write(reinterpret_cast<const char *>(values.data()),
+                 static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+template <typename T> std::vector<T> readVector(std::istream &stream)
+{
+    std::vector<T> values(readValue<uint64_t>(stream));
+    stream.read(reinterpret_cast<char *>(values.data()),
+                static_cast<std::streamsize>(values.size() * sizeof(T)));
+    if (!stream)
+    {
+        throw std::runtime_error("Unexpected end of contraction hierarchy data");
+    }
+    return values;
+}
+
+// Mutable graph used while contracting. Edges to contracted nodes are skipped, not removed
+class ContractionGraph
+{
+  public:
+    struct Arc
+    {
+        int32_t target;
+        int32_t weight;
+        int32_t middle;
+    };
+
+    explicit ContractionGraph(size_t nodeCount)
+        : m_arcs(nodeCount), m_contracted(nodeCount, false), m_contractedNeighbors(nodeCount, 0),
+          m_distance(nodeCount, Unreachable)
+    {
+    }
+
+    void AddEdge(int32_t a, int32_t b, int32_t weight, int32_t middle)
+    {
+        addArc(a, b, weight, middle);
+        addArc(b, a, weight, middle);
+    }
+
+    // Shortcuts needed to contract a node, added to the graph unless only simulating
+    int Contract(int32_t node, bool simulate, size_t &shortcutCount)
+    {
+        std::vector<Arc> neighbors;
+        for (const auto &arc : m_arcs[node])
+        {
+            if (!m_contracted[arc.target])
+            {
+                neighbors.push_back(arc);
+            }
+        }
+
+        int shortcuts = 0;
+        for (size_t i = 0; i < neighbors.size(); ++i)
+        {
+            int32_t limit = 0;
+            for (size_t j = i + 1; j < neighbors.size(); ++j)
+            {
+                limit = std::max(limit, neighbors[i].weight + neighbors[j].weight);
+            }
+            if (limit == 0)
+            {
+                continue;
+            }
+            witnessSearch(neighbors[i].target, node, limit);
+            for (size_t j = i + 1; j < neighbors.size(); ++j)
+            {
+                const int32_t viaNode = neighbors[i].weight + neighbors[j].weight;
+                if (m_distance[neighbors[j].target] <= viaNode)
+                {
+                    continue;
+                }
+                ++shortcuts;
+                if (!simulate)
+                {
+                    AddEdge(neighbors[i].target, neighbors[j].target, viaNode, node);
+                    ++shortcutCount;
+                }
+            }
+            resetWitness();
+        }
+
+        if (!simulate)
+        {
+            m_contracted[node] = true;
+            for (const auto &arc : neighbors)
+            {
+                ++m_contractedNeighbors[arc.target];
+            }
+        }
+        return shortcuts;
+    }
+
+    // Contraction order heuristic: edge difference plus the number of contracted neighbors, which
+    // spreads contraction evenly over the map
+    int Priority(int32_t node)
+    {
+        size_t unused = 0;
+        int degree = 0;
+        for (const auto &arc : m_arcs[node])
+        {
+            degree += m_contracted[arc.target] ? 0 : 1;
+        }
+        return Contract(node, true, unused) - degree + m_contractedNeighbors[node];
+    }
+
+    // Edges to neighbors that were not contracted yet, i.e. to more important nodes
+    std::vector<Arc> UpwardArcs(int32_t node) const
+    {
+        std::vector<Arc> arcs;
+        for (const auto &arc : m_arcs[node])
+        {
+            if (!m_contracted[arc.target])
+            {
+                arcs.push_back(arc);
+            }
+        }
+        return arcs;
+    }
+
+  private:
+    std::vector<std::vector<Arc>> m_arcs;
+    std::vector<bool> m_contracted;
+    std::vector<int> m_contractedNeighbors;
+    std::vector<int32_t> m_distance;
+    std::vector<int32_t> m_touched;
+
+    void addArc(int32_t from, int32_t to, int32_t weight, int32_t middle)
+    {
+        for (auto &arc : m_arcs[from])
+        {
+            if (arc.target == to)
+            {
+                if (weight < arc.weight)
+                {
+                    arc.weight = weight;
+                    arc.middle = middle;
+                }
+                return;
+            }
+        }
+        m_arcs[from].push_back({to, weight, middle});
+    }
+
+    // Bounded Dijkstra among uncontracted nodes that avoids the node being contracted
+    void witnessSearch(int32_t source, int32_t excluded, int32_t limit)
+    {
+        using Entry = std::pair<int32_t, int32_t>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+        m_distance[source] = 0;
+        m_touched.push_back(source);
+        open.push({0, source});
+        int settled = 0;
+        while (!open.empty() && settled < WitnessSettleLimit)
+        {
+            auto [distance, node] = open.top();
+            open.pop();
+            if (distance > m_distance[node])
+            {
+                continue;
+            }
+            if (distance > limit)
+            {
+                break;
+            }
+            ++settled;
+            for (const auto &arc : m_arcs[node])
+            {
+                if (arc.target == excluded || m_contracted[arc.target])
+                {
+                    continue;
+                }
+                const int32_t next = distance + arc.weight;
+                if (next < m_distance[arc.target])
+                {
+                    if (m_distance[arc.target] == Unreachable)
+                    {
+                        m_touched.push_back(arc.target);
+                    }
+                    m_distance[arc.target] = next;
+                    open.push({next, arc.target});
+                }
+            }
+        }
+    }
+
+    void resetWitness()
+    {
+        for (int32_t node : m_touched)
+        {
+            m_distance[node] = Unreachable;
+        }
+        m_touched.clear();
+    }
+};
+} // namespace
+
+/**
+ * @brief Build the hierarchy for the traversable cells of a map. Nodes are contracted in order of a
+ * lazily updated edge difference heuristic
+ *
+ * @param pathFinder Provides the map and which cells are traversable
+ *
+ */
+ContractionHierarchy::ContractionHierarchy(const PathFinder &pathFinder)
+{
+    TraceSpan span("ContractionHierarchy::Build");
+    const auto version = pathFinder.GetMapVersion();
+    m_rows = version->map.Rows();
+    m_cols = version->map.Cols();
+    m_nodeOfCell.assign(static_cast<size_t>(m_rows) * m_cols, -1);
+    for (int x = 0; x < m_rows; ++x)
+    {
+        for (int y = 0; y < m_cols; ++y)
+        {
+            if (pathFinder.IsTraversable(*version, {x, y}))
+            {
+                m_nodeOfCell[static_cast<size_t>(x) * m_cols + y] =
+                    static_cast<int32_t>(m_cells.size());
+                m_cells.push_back(x * m_cols + y);
+            }
+        }
+    }
+
+    const int32_t nodeCount = static_cast<int32_t>(m_cells.size());
+    ContractionGraph graph(m_cells.size());
+    for (int32_t node = 0; node < nodeCount; ++node)
+    {
+        const int x = m_cells[node] / m_cols;
+        const int y = m_cells[node] % m_cols;
+        // Right and lower neighbors, the graph adds both directions
+        if (y + 1 < m_cols && m_nodeOfCell[m_cells[node] + 1] >= 0)
+        {
+            graph.AddEdge(node, m_nodeOfCell[m_cells[node] + 1], 1, -1);
+        }
+        if (x + 1 < m_rows && m_nodeOfCell[m_cells[node] + m_cols] >= 0)
+        {
+            graph.AddEdge(node, m_nodeOfCell[m_cells[node] + m_cols], 1, -1);
+        }
+    }
+
+    using Entry = std::pair<int, int32_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> order;
+    for (int32_t node = 0; node < nodeCount; ++node)
+    {
+        order.push({graph.Priority(node), node});
+    }
+
+    std::vector<std::vector<ContractionGraph::Arc>> upward(m_cells.size());
+    while (!order.empty())
+    {
+        const int32_t node = order.top().second;
+        order.pop();
+        // Lazy update: contract only if the node is still the least important one
+        const int priority = graph.Priority(node);
+        if (!order.empty() && priority > order.top().first)
+        {
+            order.push({priority, node});
+            continue;
+        }
+        upward[node] = graph.UpwardArcs(node);
+        graph.Contract(node, false, m_shortcutCount);
+    }
+
+    m_firstEdge.assign(m_cells.size() + 1, 0);
+    for (int32_t node = 0; node < nodeCount; ++node)
+    {
+        m_firstEdge[node + 1] = m_firstEdge[node] + static_cast<uint32_t>(upward[node].size());
+        for (const auto &arc : upward[node])
+        {
+            m_edges.push_back({arc.target, arc.weight, arc.middle});
+        }
+    }
+}
+
+/**
+ * @brief Shortest path between two cells
+ *
+ * @param start,target Start and target cell of the query
+ *
+ * @return vector<Position> full cell path from start to target, empty if no path exists
+ *
+ */
+std::vector<Position> ContractionHierarchy::FindPath(const Position &start,
+                                                     const Position &target) const
+{
+    const int32_t source = nodeAt(start);
+    const int32_t destination = nodeAt(target);
+    if (source < 0 || destination < 0)
+    {
+        return {};
+    }
+    SearchResult result = search(source, destination, true);
+    if (result.distance < 0)
+    {
+        return {};
+    }
+
+    std::vector<Position> path;
+    path.reserve(static_cast<size_t>(result.distance) + 1);
+    path.push_back(start);
+    for (size_t i = 0; i + 1 < result.route.size(); ++i)
+    {
+        unpackEdge(result.route[i], result.route[i + 1], path);
+    }
+    return path;
+}
+
+/**
+ * @brief Length of the shortest path between two cells without unpacking it
+ *
+ * @return int number of moves, -1 if no path exists
+ *
+ */
+int ContractionHierarchy::Distance(const Position &start, const Position &target) const
+{
+    const int32_t source = nodeAt(start);
+    const int32_t destination = nodeAt(target);
+    if (source < 0 || destination < 0)
+    {
+        return -1;
+    }
+    return search(source, destination, false).distance;
+}
+
+/**
+ * @brief Write the hierarchy in a compact binary layout, see Deserialize
+ */
+void ContractionHierarchy::Serialize(std::ostream &stream) const
+{
+    writeValue<int32_t>(stream, m_rows);
+    writeValue<int32_t>(stream, m_cols);
+    writeValue<uint64_t>(stream, m_shortcutCount);
+    writeVector(stream, m_cells);
+    writeVector(stream, m_firstEdge);
+    writeVector(stream, m_edges);
+}
+
+/**
+ * @brief Read a hierarchy written by Serialize
+ *
+ * @return ContractionHierarchy ready for queries
+ *
+ */
+ContractionHierarchy ContractionHierarchy::Deserialize(std::istream &stream)
+{
+    ContractionHierarchy hierarchy;
+    hierarchy.m_rows = readValue<int32_t>(stream);
+    hierarchy.m_cols = readValue<int32_t>(stream);
+    hierarchy.m_shortcutCount = readValue<uint64_t>(stream);
+    hierarchy.m_cells = readVector<int32_t>(stream);
+    hierarchy.m_firstEdge = readVector<uint32_t>(stream);
+    hierarchy.m_edges = readVector<Edge>(stream);
+    if (hierarchy.m_rows < 0 || hierarchy.m_cols < 0 ||
+        hierarchy.m_firstEdge.size() != hierarchy.m_cells.size() + 1 ||
+        hierarchy.m_firstEdge.back() != hierarchy.m_edges.size())
+    {
+        throw std::runtime_error("Inconsistent contraction hierarchy data");
+    }
+
+    const size_t cellCount = static_cast<size_t>(hierarchy.m_rows) * hierarchy.m_cols;
+    hierarchy.m_nodeOfCell.assign(cellCount, -1);
+    for (size_t node = 0; node < hierarchy.m_cells.size(); ++node)
+    {
+        const int32_t cell = hierarchy.m_cells[node];
+        if (cell < 0 || static_cast<size_t>(cell) >= cellCount)
+        {
+            throw std::runtime_error("Inconsistent contraction hierarchy data");
+        }
+        hierarchy.m_nodeOfCell[cell] = static_cast<int32_t>(node);
+    }
+    for (const auto &edge : hierarchy.m_edges)
+    {
+        if (edge.target < 0 || static_cast<size_t>(edge.target) >= hierarchy.m_cells.size())
+        {
+            throw std::runtime_error("Inconsistent contraction hierarchy data");
+        }
+    }
+    return hierarchy;
+}
+
+/**
+ * @brief Node of a cell, -1 for blocked or out of bounds cells
+ */
+int32_t ContractionHierarchy::nodeAt(const Position &pos) const
+{
+    if (pos.x < 0 || pos.x >= m_rows || pos.y < 0 || pos.y >= m_cols)
+    {
+        return -1;
+    }
+    return m_nodeOfCell[static_cast<size_t>(pos.x) * m_cols + pos.y];
+}
+
+/**
+ * @brief Bidirectional upward Dijkstra. Both directions use the same upward edges since the grid
+ * graph is undirected, and the search stops once neither queue can improve the best meeting node
+ *
+ * @param source,target Nodes to connect
+ * @param withRoute Also return the node sequence, which may contain shortcut edges
+ *
+ * @return SearchResult with the distance, -1 if the nodes are not connected
+ *
+ */
+ContractionHierarchy::SearchResult ContractionHierarchy::search(int32_t source, int32_t target,
+                                                                bool withRoute) const
+{
+    using Entry = std::pair<int32_t, int32_t>;
+    using Queue = std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>>;
+    // Distance and parent of every reached node per direction
+    std::unordered_map<int32_t, std::pair<int32_t, int32_t>> reached[2];
+    Queue open[2];
+    reached[0][source] = {0, -1};
+    reached[1][target] = {0, -1};
+    open[0].push({0, source});
+    open[1].push({0, target});
+
+    int32_t best = Unreachable;
+    int32_t meeting = -1;
+    while (!open[0].empty() || !open[1].empty())
+    {
+        // Alternate directions, always advancing the one with the smaller key
+        int side = open[1].empty() || (!open[0].empty() && open[0].top() < open[1].top()) ? 0 : 1;
+        auto [distance, node] = open[side].top();
+        if (distance >= best)
+        {
+            // Keys only grow, so this direction cannot improve the result anymore
+            open[side] = Queue();
+            continue;
+        }
+        open[side].pop();
+        if (distance > reached[side][node].first)
+        {
+            continue;
+        }
+
+        auto other = reached[1 - side].find(node);
+        if (other != reached[1 - side].end() && distance + other->second.first < best)
+        {
+            best = distance + other->second.first;
+            meeting = node;
+        }
+
+        for (uint32_t e = m_firstEdge[node]; e < m_firstEdge[node + 1]; ++e)
+        {
+            const Edge &edge = m_edges[e];
+            const int32_t next = distance + edge.weight;
+            auto [entry, inserted] = reached[side].try_emplace(edge.target, next, node);
+            if (inserted || next < entry->second.first)
+            {
+                entry->second = {next, node};
+                open[side].push({next, edge.target});
+            }
+        }
+    }
+
+    SearchResult result;
+    if (meeting < 0)
+    {
+        return result;
+    }
+    result.distance = best;
+    if (withRoute)
+    {
+        // The forward half is counted first so the route is written in order
+        size_t forward = 0;
+        for (int32_t node = meeting; node != -1; node = reached[0][node].second)
+        {
+            ++forward;
+        }
+        result.route.resize(forward);
+        for (int32_t node = meeting; node != -1; node = reached[0][node].second)
+        {
+            result.route[--forward] = node;
+        }
+        for (int32_t node = reached[1][meeting].second; node != -1; node = reached[1][node].second)
+        {
+            result.route.push_back(node);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Upward edge between two nodes, stored at the less important one
+ */
+const ContractionHierarchy::Edge *ContractionHierarchy::findEdge(int32_t from, int32_t to) const
+{
+    for (uint32_t e = m_firstEdge[from]; e < m_firstEdge[from + 1]; ++e)
+    {
+        if (m_edges[e].target == to)
+        {
+            return &m_edges[e];
+        }
+    }
+    for (uint32_t e = m_firstEdge[to]; e < m_firstEdge[to + 1]; ++e)
+    {
+        if (m_edges[e].target == from)
+        {
+            return &m_edges[e];
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Append the cells of an edge, excluding its first node, expanding shortcuts into the
+ * original moves they bypass
+ *
+ */
+void ContractionHierarchy::unpackEdge(int32_t from, int32_t to, std::vector<Position> &path) const
+{
+    std::vector<std::pair<int32_t, int32_t>> pending = {{from, to}};
+    while (!pending.empty())
+    {
+        auto [a, b] = pending.back();
+        pending.pop_back();
+        const Edge *edge = findEdge(a, b);
+        if (!edge)
+        {
+            throw std::logic_error("Contraction hierarchy route uses a missing edge");
+        }
+        if (edge->middle < 0)
+        {
+            path.push_back({m_cells[b] / m_cols, m_cells[b] % m_cols});
+            continue;
+        }
+        // Second half is pushed first so the first half is unpacked first
+        pending.push_back({edge->middle, b});
+        pending.push_back({a, edge->middle});
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef CONTRACTION_HIERARCHY_HPP
+#define CONTRACTION_HIERARCHY_HPP
+
+// Local lib includes
+#include "PathFinder.hpp"
+
+// Standard Includes
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace PathPlanner
+{
+// Contraction hierarchy over the 4-connected graph of traversable cells of a static map. Building
+// contracts every cell in order of importance and adds shortcut edges that preserve shortest
+// distances. Queries run a bidirectional Dijkstra that only follows edges towards more important
+// cells, so they settle a few hundred nodes instead of exploring the grid, and the shortcuts on
+// the resulting route are unpacked into a full cell path. The hierarchy must be rebuilt whenever
+// the terrain changes.
+class ContractionHierarchy
+{
+  public:
+    using Position = PathFinder::Position;
+
+    // Constructors
+    ContractionHierarchy() = default;
+    explicit ContractionHierarchy(const PathFinder &pathFinder);
+
+    // Public methods
+    std::vector<Position> FindPath(const Position &start, const Position &target) const;
+    int Distance(const Position &start, const Position &target) const;
+    size_t NodeCount() const { return m_cells.size(); }
+    size_t ShortcutCount() const { return m_shortcutCount; }
+    void Serialize(std::ostream &stream) const;
+    static ContractionHierarchy Deserialize(std::istream &stream);
+
+  private:
+    // Edge from a node to a more important node. Shortcuts record the node they bypass
+    struct Edge
+    {
+        int32_t target;
+        int32_t weight;
+        int32_t middle;
+    };
+
+    struct SearchResult
+    {
+        int distance = -1;
+        std::vector<int32_t> route;
+    };
+
+    // Private members
+    int m_rows = 0;
+    int m_cols = 0;
+    // Node of every cell in row major order, -1 for blocked cells
+    std::vector<int32_t> m_nodeOfCell;
+    // Row major cell index of every node
+    std::vector<int32_t> m_cells;
+    // Upward edges of every node in compressed sparse row layout
+    std::vector<uint32_t> m_firstEdge;
+    std::vector<Edge> m_edges;
+    size_t m_shortcutCount = 0;
+
+    // Private methods
+    int32_t nodeAt(const Position &pos) const;
+    SearchResult search(int32_t source, int32_t target, bool withRoute) const;
+    const Edge *findEdge(int32_t from, int32_t to) const;
+    void unpackEdge(int32_t from, int32_t to, std::vector<Position> &path) const;
+};
+} // namespace PathPlanner
+
+#endif // CONTRACTION_HIERARCHY_HPP
@@ -0,0 +1,302 @@
+// Local lib includes
+#include "FrontierSearch.hpp"
+#include "Tracer.hpp"
+
+// Standard Includes
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
+using namespace PathPlanner;
+using Position = PathPlanner::PathFinder::Position;
+
+namespace
+{
+// Moves in opposite pairs, move ^ 1 is the move back
+constexpr int Offsets[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+
+// Ordering of the open cells, cheapest estimate first and deeper cells first among equal estimates
+struct OpenKey
+{
+    int fCost;
+    int gCost;
+    Position pos;
+
+    bool operator<(const OpenKey &other) const
+    {
+        if (fCost != other.fCost)
+        {
+            return fCost < other.fCost;
+        }
+        if (gCost != other.gCost)
+        {
+            return gCost > other.gCost;
+        }
+        return pos.x != other.pos.x ? pos.x < other.pos.x : pos.y < other.pos.y;
+    }
+};
+
+int manhattanDistance(const Position &a, const Position &b)
+{
+    return std::abs(a.x - b.x) + std::abs(a.y - b.y);
+}
+} // namespace
+
+// Node allocations of both containers hold the value next to two or four pointers of bookkeeping
+const size_t FrontierSearch::NodeBytes =
+    sizeof(std::pair<const Position, FrontierSearch::OpenCell>) + 2 * sizeof(void *) +
+    sizeof(OpenKey) + 4 * sizeof(void *);
+
+/**
+ * @brief Constructor for the FrontierSearch Class
+ *
+ * @param pathFinder PathFinder providing the map, must outlive the search
+ * @param options Memory limit of each query. Throws std::invalid_argument if a limit is set that
+ * cannot hold MinNodes open cells
+ *
+ */
+FrontierSearch::FrontierSearch(const PathFinder &pathFinder, Options options)
+    : m_pathFinder(pathFinder), m_options(options), m_maxNodes(options.memoryLimit / NodeBytes)
+{
+    if (m_options.memoryLimit != 0 && m_maxNodes < MinNodes)
+    {
+        throw std::invalid_argument("Memory limit is too small for a frontier search");
+    }
+}
+
+/**
+ * @brief Plan the shortest path between two cells within the memory limit. Only straight moves
+ * are used, as in FindPath with the default QueryOptions
+ *
+ * @param start,target Start and target cell
+ * @param shouldStop Optional, polled every few hundred expansions. The query is abandoned with an
+ * empty path once it returns true
+ *
+ * @return Result with the path and the memory used. The path is empty if the cells are blocked or
+ * not connected. If the memory limit dropped every way to the target, the path leads to the
+ * explored cell closest to it
+ *
+ */
+FrontierSearch::Result FrontierSearch::FindPath(const Position &start, const Position &target,
+                                                const std::function<bool()> &shouldStop) const
+{
+    TraceSpan span("FrontierSearch::FindPath");
+    Result result;
+    const auto version = m_pathFinder.GetMapVersion();
+    // Only labels the version already has are used, the check never builds anything
+    if (!m_pathFinder.AreConnected(*version, start, target))
+    {
+        return result;
+    }
+
+    // No path without repeated cells is longer than the cell count. The cost is not known yet, so
+    // the relay is a guess that recoverPath corrects with one more search
+    const int costBound = version->map.Rows() * version->map.Cols();
+    std::optional<Segment> segment =
+        searchSegment(*version, start, target, costBound, (manhattanDistance(start, target) + 1) / 2,
+                      true, shouldStop, result);
+    if (segment && !(segment->end == target) && result.optimal)
+    {
+        // Every reachable cell was explored, so the target is not connected
+        return result;
+    }
+    if (segment && !(segment->end == target))
+    {
+        // The memory limit cut off every way to the target, plan the way to the closest cell
+        segment = searchSegment(*version, start, segment->end, segment->cost, segment->cost / 2,
+                                false, shouldStop, result);
+    }
+    if (!segment)
+    {
+        return result;
+    }
+
+    result.path.reserve(segment->cost + 1);
+    result.path.push_back(start);
+    if (!recoverPath(*version, start, segment->end, *segment, shouldStop, result))
+    {
+        result.path.clear();
+    }
+    result.reachesTarget = !result.path.empty() && result.path.back() == target;
+    return result;
+}
+
+/**
+ * @brief Frontier A* between two cells that only keeps the open cells
+ *
+ * @param version Map version to search
+ * @param start,target Start and target cell of the segment
+ * @param costBound Cells with a larger estimated path cost are not expanded. They stay open so
+ * their moves back are remembered, and are the first to go under the memory limit
+ * @param relayCost Path cost at which the relay cell is recorded
+ * @param allowPartial Return the expanded cell closest to the target if the target is not found
+ * @param shouldStop Optional, the segment is abandoned once it returns true
+ * @param result Receives the memory and expansion statistics
+ *
+ * @return Cost of the segment and the cell of its path at relayCost, std::nullopt if no path
+ * within the bound was found. Partial segments end at the closest cell and carry no relay
+ *
+ */
+std::optional<FrontierSearch::Segment>
+FrontierSearch::searchSegment(const PathFinder::MapVersion &version, const Position &start,
+                              const Position &target, int costBound, int relayCost,
+                              bool allowPartial, const std::function<bool()> &shouldStop,
+                              Result &result) const
+{
+    constexpr size_t StopCheckInterval = 256;
+    // Once cells were dropped, expanded cells can be reached again, so the expansions are capped
+    const size_t maxExpansions = static_cast<size_t>(version.map.Rows()) * version.map.Cols();
+    size_t expansions = 0;
+    Segment closest{start, 0, start, -1};
+    int closestDistance = manhattanDistance(start, target);
+    std::unordered_map<Position, OpenCell> openCells;
+    std::set<OpenKey> openList;
+    openCells[start] = {0, start, 0};
+    openList.insert({manhattanDistance(start, target), 0, start});
+
+    while (!openList.empty())
+    {
+        const OpenKey key = *openList.begin();
+        if (key.fCost > costBound)
+        {
+            break;
+        }
+        openList.erase(openList.begin());
+        auto found = openCells.find(key.pos);
+        const OpenCell current = found->second;
+        // Expanded cells are forgotten, their neighbors remember the move back instead
+        openCells.erase(found);
+        if (key.pos == target)
+        {
+            return Segment{target, current.gCost, current.relay, relayCost};
+        }
+        ++result.expandedNodes;
+        if (shouldStop && result.expandedNodes % StopCheckInterval == 0 && shouldStop())
+        {
+            return std::nullopt;
+        }
+        if (!result.optimal && ++expansions > maxExpansions)
+        {
+            break;
+        }
+        const int distance = key.fCost - key.gCost;
+        if (distance < closestDistance)
+        {
+            closest = {key.pos, current.gCost, key.pos, -1};
+            closestDistance = distance;
+        }
+
+        for (int move = 0; move < 4; ++move)
+        {
+            if (current.usedMoves & (1 << move))
+            {
+                continue;
+            }
+            const Position neighbor(key.pos.x + Offsets[move][0], key.pos.y + Offsets[move][1]);
+            const int gCost = current.gCost + 1;
+            const int fCost = gCost + manhattanDistance(neighbor, target);
+            if (!m_pathFinder.IsTraversable(version, neighbor))
+            {
+                continue;
+            }
+            const uint8_t moveBack = 1 << (move ^ 1);
+            const Position relay = current.gCost < relayCost && gCost >= relayCost
+                                       ? neighbor
+                                       : current.relay;
+
+            auto existing = openCells.find(neighbor);
+            if (existing != openCells.end())
+            {
+                OpenCell &cell = existing->second;
+                cell.usedMoves |= moveBack;
+                if (gCost < cell.gCost)
+                {
+                    openList.erase({cell.gCost + fCost - gCost, cell.gCost, neighbor});
+                    cell.gCost = gCost;
+                    cell.relay = relay;
+                    openList.insert({fCost, gCost, neighbor});
+                }
+                continue;
+            }
+
+            openCells[neighbor] = {gCost, relay, moveBack};
+            openList.insert({fCost, gCost, neighbor});
+            if (m_maxNodes != 0 && openCells.size() > m_maxNodes)
+            {
+                // Drop the open cell least likely to lie on the shortest path
+                auto worst = std::prev(openList.end());
+                openCells.erase(worst->pos);
+                openList.erase(worst);
+                result.optimal = false;
+            }
+        }
+        result.peakNodes = std::max(result.peakNodes, openCells.size());
+        result.peakMemory = result.peakNodes * NodeBytes;
+    }
+    if (allowPartial)
+    {
+        return closest;
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Append the cells of a segment after its start to the result path, by searching both
+ * halves of the segment again until only single moves remain. Both halves are searched with their
+ * exact cost as bound and relay at half of it, so each level halves the cost. A segment whose
+ * relay is not at half its cost, e.g. the first search of a query, is searched once more
+ *
+ * @param version Map version to search
+ * @param start,target Start and target cell of the segment
+ * @param segment Cost and relay cell found by searchSegment
+ * @param shouldStop Optional, recovery is abandoned once it returns true
+ * @param result Receives the cells and the search statistics
+ *
+ * @return false if a half could not be searched again within the memory limit or the search was
+ * stopped
+ *
+ */
+bool FrontierSearch::recoverPath(const PathFinder::MapVersion &version, const Position &start,
+                                 const Position &target, const Segment &segment,
+                                 const std::function<bool()> &shouldStop, Result &result) const
+{
+    if (segment.cost <= 1)
+    {
+        if (segment.cost == 1)
+        {
+            result.path.push_back(target);
+        }
+        return true;
+    }
+
+    // Searches that dropped cells may find a cheaper segment again, so the cost shrinks each time
+    std::optional<Segment> split = segment;
+    while (split && split->cost > 1 && split->relayCost != split->cost / 2)
+    {
+        split = searchSegment(version, start, target, split->cost, split->cost / 2, false,
+                              shouldStop, result);
+    }
+    if (!split)
+    {
+        return false;
+    }
+    if (split->cost <= 1)
+    {
+        return recoverPath(version, start, target, *split, shouldStop, result);
+    }
+
+    const int half = split->cost / 2;
+    const Position relay = split->relay;
+    const std::optional<Segment> first =
+        searchSegment(version, start, relay, half, half / 2, false, shouldStop, result);
+    if (!first || !recoverPath(version, start, relay, *first, shouldStop, result))
+    {
+        return false;
+    }
+    const int rest = split->cost - half;
+    const std::optional<Segment> second =
+        searchSegment(version, relay, target, rest, rest / 2, false, shouldStop, result);
+    return second && recoverPath(version, relay, target, *second, shouldStop, result);
+}
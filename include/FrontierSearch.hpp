@@ -0,0 +1,99 @@
+#ifndef FRONTIER_SEARCH_HPP
+#define FRONTIER_SEARCH_HPP
+
+// Local lib includes
+#include "PathFinder.hpp"
+
+// Standard Includes
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace PathPlanner
+{
+// Memory bounded single cell search for maps too large to keep every explored cell. Divide and
+// conquer frontier search: only the open cells are stored, each remembering which of its moves lead
+// back into the explored area, so memory grows with the perimeter of the search instead of its
+// area. Every open cell carries the cell where its path crossed half of the path cost, and the path
+// is recovered by recursively searching the two halves, so the recursion depth is logarithmic in
+// the cost. A memory limit caps the open cells,
+// dropping the ones with the highest estimated cost once it is reached, and a query that loses every
+// way to the target returns the path to the closest cell it explored.
+class FrontierSearch
+{
+  public:
+    using Position = PathFinder::Position;
+
+    struct Options
+    {
+        // Bytes of search state a query may hold, 0 for no limit. Must fit at least MinNodes cells
+        size_t memoryLimit = 0;
+    };
+
+    struct Result
+    {
+        // Cells from the start, empty if the cells are blocked or not connected
+        std::vector<Position> path;
+        // False if the memory limit cut off every way to the target, the path then ends at the
+        // explored cell closest to it so the unit can move on and plan again from there. On maps
+        // without component labels this also covers targets that are not connected at all
+        bool reachesTarget = false;
+        // False once the memory limit dropped cells, the path may then be longer than the shortest
+        bool optimal = true;
+        // Largest search state held during the query, in bytes and in open cells
+        size_t peakMemory = 0;
+        size_t peakNodes = 0;
+        size_t expandedNodes = 0;
+    };
+
+    // Approximate heap bytes of one open cell, its hash map entry and its ordered set entry
+    static const size_t NodeBytes;
+    static constexpr size_t MinNodes = 8;
+
+    // Constructor
+    FrontierSearch(const PathFinder &pathFinder, Options options);
+    explicit FrontierSearch(const PathFinder &pathFinder) : FrontierSearch(pathFinder, Options()) {}
+
+    // Public methods
+    Result FindPath(const Position &start, const Position &target,
+                    const std::function<bool()> &shouldStop = {}) const;
+
+  private:
+    struct OpenCell
+    {
+        int gCost;
+        // Cell where the path to this cell crossed the relay cost of the search
+        Position relay;
+        // Bit per move that leads to an already expanded cell
+        uint8_t usedMoves;
+    };
+
+    struct Segment
+    {
+        Position end;
+        int cost;
+        // Cell of the path at relayCost, the segment splits in half if relayCost is cost / 2
+        Position relay;
+        int relayCost;
+    };
+
+    // Private members
+    const PathFinder &m_pathFinder;
+    Options m_options;
+    size_t m_maxNodes;
+
+    // Private methods
+    std::optional<Segment> searchSegment(const PathFinder::MapVersion &version,
+                                         const Position &start, const Position &target,
+                                         int costBound, int relayCost, bool allowPartial,
+                                         const std::function<bool()> &shouldStop,
+                                         Result &result) const;
+    bool recoverPath(const PathFinder::MapVersion &version, const Position &start,
+                     const Position &target, const Segment &segment,
+                     const std::function<bool()> &shouldStop, Result &result) const;
+};
+} // namespace PathPlanner
+
+#endif // FRONTIER_SEARCH_HPP
@@ -0,0 +1,251 @@
+// Local lib includes
+#include "MapRenderer.hpp"
+
+// Standard Includes
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+using namespace PathPlanner;
+using Position = PathPlanner::PathFinder::Position;
+
+namespace
+{
+// Paths cycle through red, green, yellow, blue, magenta and cyan
+constexpr int PathColorCount = 6;
+constexpr std::array<std::array<uint8_t, 3>, PathColorCount> PathColors = {{
+    {205, 49, 49},
+    {13, 188, 121},
+    {229, 229, 16},
+    {36, 114, 200},
+    {188, 63, 188},
+    {17, 168, 205},
+}};
+constexpr std::array<uint8_t, 3> StartColor = {255, 255, 255};
+constexpr std::array<uint8_t, 3> TargetColor = {255, 140, 0};
+constexpr std::array<uint8_t, 3> ElevatedColor = {64, 64, 64};
+constexpr std::array<uint8_t, 3> ReachableColor = {200, 200, 200};
+constexpr std::array<uint8_t, 3> UnknownColor = {0, 0, 0};
+} // namespace
+
+/**
+ * @brief Constructor for the MapRenderer Class
+ *
+ * @param map Grid to draw, must outlive the renderer
+ * @param legend Terrain values drawn as obstacles and free space
+ *
+ */
+MapRenderer::MapRenderer(const ChunkedGrid &map, Legend legend)
+    : m_map(map), m_legend(legend),
+      m_markers(static_cast<size_t>(map.Rows()) * map.Cols(), NoMarker),
+      m_paths(static_cast<size_t>(map.Rows()) * map.Cols(), -1)
+{
+}
+
+/**
+ * @brief Rasterize the start and target positions of all units. When a cell is used by several
+ * units, the lowest unit index decides and a start wins over a target of the same unit
+ *
+ * @param starts,targets Start and target position of each unit
+ *
+ */
+void MapRenderer::SetMarkers(const std::vector<Position> &starts,
+                             const std::vector<Position> &targets)
+{
+    std::fill(m_markers.begin(), m_markers.end(), NoMarker);
+    for (size_t i = std::max(starts.size(), targets.size()); i-- > 0;)
+    {
+        if (i < targets.size() && isInside(targets[i]))
+        {
+            m_markers[static_cast<size_t>(targets[i].x) * m_map.Cols() + targets[i].y] =
+                TargetMarker;
+        }
+        if (i < starts.size() && isInside(starts[i]))
+        {
+            m_markers[static_cast<size_t>(starts[i].x) * m_map.Cols() + starts[i].y] = StartMarker;
+        }
+    }
+}
+
+/**
+ * @brief Fill the path overlay from any list of iterable paths
+ *
+ */
+template <typename PathList> void MapRenderer::rasterizePaths(const PathList &paths)
+{
+    std::fill(m_paths.begin(), m_paths.end(), -1);
+    for (size_t i = 0; i < paths.size(); ++i)
+    {
+        for (const auto &pos : paths[i])
+        {
+            if (isInside(pos))
+            {
+                m_paths[static_cast<size_t>(pos.x) * m_map.Cols() + pos.y] = static_cast<int32_t>(i);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Rasterize the solved paths. Cells covered by several paths take the color of the last one
+ *
+ * @param paths Solved path of each unit, may contain empty paths
+ *
+ */
+void MapRenderer::SetPaths(const std::vector<std::vector<Position>> &paths)
+{
+    rasterizePaths(paths);
+}
+
+/**
+ * @brief Rasterize run length encoded paths, expanding them cell by cell without materializing them
+ *
+ * @param paths Compressed path of every unit, later paths are drawn over earlier ones
+ *
+ */
+void MapRenderer::SetPaths(const std::vector<CompressedPath> &paths)
+{
+    rasterizePaths(paths);
+}
+
+/**
+ * @brief Render the map as text: S start, T target, colored P path, # obstacle and . free space
+ *
+ * @return std::string with one line per map row
+ *
+ */
+std::string MapRenderer::RenderAnsi() const
+{
+    const int rows = m_map.Rows();
+    const int cols = m_map.Cols();
+    std::string output;
+    // Two characters per plain cell, colored path cells need up to eleven
+    output.reserve(static_cast<size_t>(rows) * (cols * 4 + 1));
+
+    for (int x = 0; x < rows; ++x)
+    {
+        for (int y = 0; y < cols; ++y)
+        {
+            const size_t cell = static_cast<size_t>(x) * cols + y;
+            if (m_markers[cell] == StartMarker)
+            {
+                output += "S "; // Start
+            }
+            else if (m_markers[cell] == TargetMarker)
+            {
+                output += "T "; // Target
+            }
+            else if (m_paths[cell] >= 0)
+            {
+                output += "\033[";
+                output += std::to_string(31 + m_paths[cell] % PathColorCount);
+                output += "mP \033[0m"; // Path
+            }
+            else
+            {
+                const int value = m_map.At(x, y);
+                if (value == m_legend.elevated)
+                {
+                    output += "# "; // Obstacle
+                }
+                else if (value == m_legend.reachable)
+                {
+                    output += ". "; // Free space
+                }
+            }
+        }
+        output += '\n';
+    }
+    return output;
+}
+
+/**
+ * @brief Render the map as text and write it to the stream in a single call
+ *
+ */
+void MapRenderer::WriteAnsi(std::ostream &stream) const
+{
+    const std::string output = RenderAnsi();
+    stream.write(output.data(), static_cast<std::streamsize>(output.size()));
+    stream.flush();
+}
+
+/**
+ * @brief Export the map as a binary PPM (P6) image, suitable for maps too large for a terminal
+ *
+ * @param filePath Destination path
+ * @param cellPixels Edge length in pixels of each map cell
+ *
+ */
+void MapRenderer::WritePPM(const std::string &filePath, int cellPixels) const
+{
+    if (cellPixels <= 0)
+    {
+        throw std::invalid_argument("Cell size in pixels must be positive");
+    }
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::cerr << "Image export error at file: " << __FILE__ << ", line: " << __LINE__
+                  << std::endl;
+        throw std::runtime_error("Failed to open image file for writing: " + filePath);
+    }
+
+    const int rows = m_map.Rows();
+    const int cols = m_map.Cols();
+    file << "P6\n" << cols * cellPixels << " " << rows * cellPixels << "\n255\n";
+
+    std::vector<uint8_t> scanline(static_cast<size_t>(cols) * cellPixels * 3);
+    for (int x = 0; x < rows; ++x)
+    {
+        for (int y = 0; y < cols; ++y)
+        {
+            const size_t cell = static_cast<size_t>(x) * cols + y;
+            std::array<uint8_t, 3> color = UnknownColor;
+            if (m_markers[cell] == StartMarker)
+            {
+                color = StartColor;
+            }
+            else if (m_markers[cell] == TargetMarker)
+            {
+                color = TargetColor;
+            }
+            else if (m_paths[cell] >= 0)
+            {
+                color = PathColors[m_paths[cell] % PathColorCount];
+            }
+            else if (m_map.At(x, y) == m_legend.elevated)
+            {
+                color = ElevatedColor;
+            }
+            else if (m_map.At(x, y) == m_legend.reachable)
+            {
+                color = ReachableColor;
+            }
+            for (int p = 0; p < cellPixels; ++p)
+            {
+                std::copy(color.begin(), color.end(),
+                          scanline.begin() + (static_cast<size_t>(y) * cellPixels + p) * 3);
+            }
+        }
+        for (int p = 0; p < cellPixels; ++p)
+        {
+            file.write(reinterpret_cast<const char *>(scanline.data()),
+                       static_cast<std::streamsize>(scanline.size()));
+        }
+    }
+    if (!file)
+    {
+        throw std::runtime_error("Failed to write image file: " + filePath);
+    }
+}
+
+/**
+ * @brief Check if a position lies on the map
+ *
+ */
+bool MapRenderer::isInside(const Position &pos) const
+{
+    return pos.x >= 0 && pos.x < m_map.Rows() && pos.y >= 0 && pos.y < m_map.Cols();
+}
@@ -0,0 +1,65 @@
+#ifndef MAP_RENDERER_HPP
+#define MAP_RENDERER_HPP
+
+// Local lib includes
+#include "ChunkedGrid.hpp"
+#include "CompressedPath.hpp"
+#include "PathFinder.hpp"
+
+// Standard Includes
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace PathPlanner
+{
+// Draws a map with unit markers and solved paths. Markers and paths are rasterized once into a
+// per cell overlay buffer, so rendering costs O(rows * cols + total path length) regardless of
+// the number of units. Output is either ANSI text written in one block or a binary PPM image.
+class MapRenderer
+{
+  public:
+    using Position = PathFinder::Position;
+
+    // Terrain values drawn as obstacles and free space
+    struct Legend
+    {
+        int elevated;
+        int reachable;
+    };
+
+    // Constructor
+    MapRenderer(const ChunkedGrid &map, Legend legend);
+
+    // Public methods
+    void SetMarkers(const std::vector<Position> &starts, const std::vector<Position> &targets);
+    void SetPaths(const std::vector<std::vector<Position>> &paths);
+    void SetPaths(const std::vector<CompressedPath> &paths);
+    std::string RenderAnsi() const;
+    void WriteAnsi(std::ostream &stream) const;
+    void WritePPM(const std::string &filePath, int cellPixels = 1) const;
+
+  private:
+    enum Marker : uint8_t
+    {
+        NoMarker = 0,
+        StartMarker = 1,
+        TargetMarker = 2,
+    };
+
+    // Private members
+    const ChunkedGrid &m_map;
+    Legend m_legend;
+    // Per cell overlays in row major order, markers take precedence over paths
+    std::vector<uint8_t> m_markers;
+    // Index of the last path covering each cell, -1 if none
+    std::vector<int32_t> m_paths;
+
+    // Private methods
+    bool isInside(const Position &pos) const;
+    template <typename PathList> void rasterizePaths(const PathList &paths);
+};
+} // namespace PathPlanner
+
+#endif // MAP_RENDERER_HPP
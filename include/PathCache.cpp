@@ -0,0 +1,173 @@
+// Local lib includes
+#include "PathCache.hpp"
+#include "Tracer.hpp"
+
+// Standard Includes
+#include <algorithm>
+#include <stdexcept>
+using namespace PathPlanner;
+using Position = PathPlanner::PathFinder::Position;
+
+/**
+ * @brief Constructor for the PathCache Class
+ *
+ * @param pathFinder PathFinder providing the map, must outlive the cache
+ * @param options Cache limits. Throws std::invalid_argument if a limit is 0
+ *
+ */
+PathCache::PathCache(const PathFinder &pathFinder, Options options)
+    : m_pathFinder(pathFinder), m_options(options)
+{
+    if (m_options.maxTargets == 0 || m_options.maxCellsPerTarget == 0)
+    {
+        throw std::invalid_argument("Path cache limits must be positive");
+    }
+}
+
+size_t PathCache::KeyHash::operator()(const Key &key) const noexcept
+{
+    return std::hash<Position>()(key.target) ^ (static_cast<size_t>(key.unitSize) << 20) ^
+           (static_cast<size_t>(key.movementClass) << 24) ^
+           (static_cast<size_t>(key.allowDiagonal) << 31);
+}
+
+/**
+ * @brief Plan a shortest path, continuing along a cached path to the same target as soon as the
+ * search reaches one of its cells. The path is cached for later queries. Safe to call from several
+ * threads
+ *
+ * @param start,target Start and target position of the query
+ * @param options Per query settings, see PathFinder::FindPath. Queries with dynamic obstacles are
+ * neither answered from nor added to the cache
+ *
+ * @return Result with the path and whether a cached path was reused
+ *
+ */
+PathCache::Result PathCache::FindPath(const Position &start, const Position &target,
+                                      const PathFinder::QueryOptions &options) const
+{
+    TraceSpan span("PathCache::FindPath");
+    Result result;
+    if (options.isBlocked)
+    {
+        result.path = m_pathFinder.FindPath(start, target, options);
+        return result;
+    }
+
+    const Key key{target, std::max(options.unitSize, 1), options.allowDiagonal,
+                  options.movementClass};
+    const auto version = m_pathFinder.GetMapVersion();
+    std::shared_ptr<const RouteTree> routes;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto found = m_targets.find(key);
+        if (found != m_targets.end() && found->second.version == version)
+        {
+            routes = found->second.routes;
+            found->second.lastUse = ++m_useCount;
+        }
+    }
+
+    if (!routes)
+    {
+        result.path = m_pathFinder.FindPath(start, target, options);
+    }
+    else
+    {
+        const auto knownCost = [&routes](const Position &pos) {
+            auto hop = routes->find(pos);
+            return hop == routes->end() ? -1 : hop->second.cost;
+        };
+        result.path = m_pathFinder.FindPathToKnownCells(start, target, knownCost, options);
+    }
+
+    // Routes of an edited map may cross cells that are blocked now
+    if (m_pathFinder.GetMapVersion() != version)
+    {
+        result.path = m_pathFinder.FindPath(start, target, options);
+        return result;
+    }
+    if (result.path.empty())
+    {
+        return result;
+    }
+    if (!(result.path.back() == target))
+    {
+        result.spliced = true;
+        while (!(result.path.back() == target))
+        {
+            result.path.push_back(routes->at(result.path.back()).next);
+        }
+    }
+    storePath(key, version, result.path);
+    return result;
+}
+
+/**
+ * @brief Total number of cells cached over all targets
+ *
+ */
+size_t PathCache::GetCachedCells() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t cells = 0;
+    for (const auto &[key, cached] : m_targets)
+    {
+        cells += cached.routes->size();
+    }
+    return cells;
+}
+
+/**
+ * @brief Drop every cached path
+ *
+ */
+void PathCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_targets.clear();
+}
+
+/**
+ * @brief Add the cells of a shortest path to the routes of its target. Cells already cached keep
+ * their next cell, both lead to the target at the same cost
+ *
+ * @param key Target and rules the path was planned with
+ * @param version Map version the path was planned on
+ * @param path Path ending at the target
+ *
+ */
+void PathCache::storePath(const Key &key,
+                          const std::shared_ptr<const PathFinder::MapVersion> &version,
+                          const std::vector<Position> &path) const
+{
+    const int straightCost = key.allowDiagonal ? PathFinder::OctileStraightCost : 1;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    CachedTarget &cached = m_targets[key];
+    const bool extend = cached.routes && cached.version == version &&
+                        cached.routes->size() + path.size() <= m_options.maxCellsPerTarget;
+    auto routes = extend ? std::make_shared<RouteTree>(*cached.routes)
+                         : std::make_shared<RouteTree>();
+    routes->try_emplace(path.back(), Hop{path.back(), 0});
+    int cost = 0;
+    for (size_t i = path.size() - 1; i > 0; --i)
+    {
+        const Position &cell = path[i - 1];
+        const Position &next = path[i];
+        const bool diagonal = cell.x != next.x && cell.y != next.y;
+        cost += diagonal ? PathFinder::OctileDiagonalCost : straightCost;
+        routes->try_emplace(cell, Hop{next, cost});
+    }
+    cached.version = version;
+    cached.routes = std::move(routes);
+    cached.lastUse = ++m_useCount;
+
+    if (m_targets.size() > m_options.maxTargets)
+    {
+        auto oldest = std::min_element(m_targets.begin(), m_targets.end(),
+                                       [](const auto &a, const auto &b) {
+                                           return a.second.lastUse < b.second.lastUse;
+                                       });
+        m_targets.erase(oldest);
+    }
+}
@@ -0,0 +1,103 @@
+#ifndef PATH_CACHE_HPP
+#define PATH_CACHE_HPP
+
+// Local lib includes
+#include "PathFinder.hpp"
+
+// Standard Includes
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace PathPlanner
+{
+// Reuses recent paths for units heading to the same target, e.g. a squad given one move order.
+// Every cell of a cached path remembers its next cell and remaining cost towards the target, so a
+// query only searches until it reaches a cell of an earlier path and continues along it. Queries
+// for targets without cached paths run a full search, whose path is cached for the next unit.
+class PathCache
+{
+  public:
+    using Position = PathFinder::Position;
+
+    struct Options
+    {
+        // Targets whose paths are kept, the least recently queried target is dropped first
+        size_t maxTargets = 64;
+        // Cells kept per target, the older paths of a target are dropped once it is exceeded
+        size_t maxCellsPerTarget = 1 << 16;
+    };
+
+    struct Result
+    {
+        // Shortest path from the start, empty if none exists or the search was stopped
+        std::vector<Position> path;
+        // True if the path continues along an earlier path to the target
+        bool spliced = false;
+    };
+
+    // Constructor
+    PathCache(const PathFinder &pathFinder, Options options);
+    explicit PathCache(const PathFinder &pathFinder) : PathCache(pathFinder, Options()) {}
+
+    // Public methods
+    Result FindPath(const Position &start, const Position &target,
+                    const PathFinder::QueryOptions &options = {}) const;
+    size_t GetCachedCells() const;
+    void Clear();
+
+  private:
+    // Paths only share cells if they were planned with the same rules
+    struct Key
+    {
+        Position target;
+        int unitSize;
+        bool allowDiagonal;
+        int movementClass;
+
+        bool operator==(const Key &other) const
+        {
+            return target == other.target && unitSize == other.unitSize &&
+                   allowDiagonal == other.allowDiagonal && movementClass == other.movementClass;
+        }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key &key) const noexcept;
+    };
+
+    struct Hop
+    {
+        Position next;
+        int cost;
+    };
+    // Next cell and remaining cost of every cached cell, forming a tree rooted at the target
+    using RouteTree = std::unordered_map<Position, Hop>;
+
+    struct CachedTarget
+    {
+        // Routes are only valid on the map version they were planned on
+        std::shared_ptr<const PathFinder::MapVersion> version;
+        // Replaced instead of modified, so queries search against it without holding the lock
+        std::shared_ptr<const RouteTree> routes;
+        uint64_t lastUse = 0;
+    };
+
+    // Private members
+    const PathFinder &m_pathFinder;
+    Options m_options;
+    mutable std::mutex m_mutex;
+    mutable std::unordered_map<Key, CachedTarget, KeyHash> m_targets;
+    mutable uint64_t m_useCount = 0;
+
+    // Private methods
+    void storePath(const Key &key, const std::shared_ptr<const PathFinder::MapVersion> &version,
+                   const std::vector<Position> &path) const;
+};
+} // namespace PathPlanner
+
+#endif // PATH_CACHE_HPP
@@ -0,0 +1,156 @@
+// Local lib includes
+#include "PathClient.hpp"
+
+// System Includes
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Standard Includes
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+using namespace PathPlanner;
+using Position = PathPlanner::PathFinder::Position;
+
+/**
+ * @brief Constructor for the PathClient Class. Connects to a running path server
+ *
+ * @param socketPath File system path of the server's Unix domain socket
+ *
+ */
+PathClient::PathClient(const std::string &socketPath)
+{
+    sockaddr_un address{};
+    if (socketPath.size() >= sizeof(address.sun_path))
+    {
+        throw std::runtime_error("Socket path too long: " + socketPath);
+    }
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    m_socketFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_socketFd < 0 ||
+        ::connect(m_socketFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0)
+    {
+        std::string error = std::strerror(errno);
+        if (m_socketFd >= 0)
+        {
+            ::close(m_socketFd);
+        }
+        throw std::runtime_error("Failed to connect to " + socketPath + ": " + error);
+    }
+}
+
+/**
+ * @brief Destructor for the PathClient Class. Closes the connection
+ */
+PathClient::~PathClient()
+{
+    if (m_socketFd >= 0)
+    {
+        ::close(m_socketFd);
+    }
+}
+
+/**
+ * @brief Plan a batch of paths on one of the server's maps
+ *
+ * @param mapId Index of the map in the server's config list
+ * @param queries Start and target position of each query
+ *
+ * @return vector of paths in query order, empty for queries without a path
+ *
+ */
+std::vector<std::vector<Position>> PathClient::FindPaths(uint32_t mapId,
+                                                         const std::vector<Query> &queries)
+{
+    std::vector<Protocol::QueryRecord> records;
+    records.reserve(queries.size());
+    for (const auto &[start, target] : queries)
+    {
+        records.push_back({start.x, start.y, target.x, target.y});
+    }
+
+    Protocol::ResponseHeader header = sendRequest(Protocol::RequestType::Query, mapId, records);
+    std::vector<std::vector<Position>> paths(header.count);
+    for (auto &path : paths)
+    {
+        uint32_t length = 0;
+        if (!Protocol::ReadExact(m_socketFd, &length, sizeof(length)))
+        {
+            throw std::runtime_error("Connection closed while reading paths");
+        }
+        std::vector<int32_t> cells(static_cast<size_t>(length) * 2);
+        if (!Protocol::ReadExact(m_socketFd, cells.data(), cells.size() * sizeof(int32_t)))
+        {
+            throw std::runtime_error("Connection closed while reading paths");
+        }
+        path.reserve(length);
+        for (uint32_t i = 0; i < length; ++i)
+        {
+            path.emplace_back(cells[2 * i], cells[2 * i + 1]);
+        }
+    }
+    return paths;
+}
+
+/**
+ * @brief Query dimensions and unit count of one of the server's maps
+ *
+ * @param mapId Index of the map in the server's config list
+ *
+ */
+Protocol::MapInfo PathClient::GetMapInfo(uint32_t mapId)
+{
+    sendRequest(Protocol::RequestType::MapInfo, mapId, {});
+    Protocol::MapInfo info;
+    if (!Protocol::ReadExact(m_socketFd, &info, sizeof(info)))
+    {
+        throw std::runtime_error("Connection closed while reading map info");
+    }
+    return info;
+}
+
+/**
+ * @brief Send a request and read the response header, throwing on protocol errors
+ *
+ */
+Protocol::ResponseHeader PathClient::sendRequest(Protocol::RequestType type, uint32_t mapId,
+                                                 const std::vector<Protocol::QueryRecord> &records)
+{
+    Protocol::RequestHeader request{Protocol::Magic, Protocol::Version,
+                                    static_cast<uint16_t>(type), mapId,
+                                    static_cast<uint32_t>(records.size())};
+    std::vector<char> buffer(sizeof(request) + records.size() * sizeof(Protocol::QueryRecord));
+    std::memcpy(buffer.data(), &request, sizeof(request));
+    if (!records.empty())
+    {
+        std::memcpy(buffer.data() + sizeof(request), records.data(),
+                    records.size() * sizeof(Protocol::QueryRecord));
+    }
+    if (!Protocol::WriteExact(m_socketFd, buffer.data(), buffer.size()))
+    {
+        throw std::runtime_error("Failed to send request");
+    }
+
+    Protocol::ResponseHeader header;
+    if (!Protocol::ReadExact(m_socketFd, &header, sizeof(header)) ||
+        header.magic != Protocol::Magic)
+    {
+        throw std::runtime_error("Invalid response from server");
+    }
+    switch (static_cast<Protocol::Status>(header.status))
+    {
+    case Protocol::Status::Ok:
+        return header;
+    case Protocol::Status::UnknownMap:
+        throw std::out_of_range("Unknown map id: " + std::to_string(mapId));
+    case Protocol::Status::InternalError:
+        throw std::runtime_error("Server failed to answer the request");
+    case Protocol::Status::Busy:
+        throw std::runtime_error("Server is at its connection limit");
+    default:
+        throw std::runtime_error("Server rejected the request");
+    }
+}
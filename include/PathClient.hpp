@@ -0,0 +1,45 @@
+#ifndef PATH_CLIENT_HPP
+#define PATH_CLIENT_HPP
+
+// Local lib includes
+#include "PathFinder.hpp"
+#include "PathProtocol.hpp"
+
+// Standard Includes
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace PathPlanner
+{
+// Client side of the path server protocol. Keeps one connection open for any number of requests
+class PathClient
+{
+  public:
+    using Position = PathFinder::Position;
+    using Query = std::pair<Position, Position>;
+
+    // Constructor, connects to the server socket
+    explicit PathClient(const std::string &socketPath);
+
+    // Destructor, closes the connection
+    ~PathClient();
+
+    PathClient(const PathClient &) = delete;
+    PathClient &operator=(const PathClient &) = delete;
+
+    // Public methods
+    std::vector<std::vector<Position>> FindPaths(uint32_t mapId, const std::vector<Query> &queries);
+    Protocol::MapInfo GetMapInfo(uint32_t mapId);
+
+  private:
+    // Private members
+    int m_socketFd = -1;
+
+    // Private methods
+    Protocol::ResponseHeader sendRequest(Protocol::RequestType type, uint32_t mapId,
+                                         const std::vector<Protocol::QueryRecord> &records);
+};
+} // namespace PathPlanner
+
+#endif // PATH_CLIENT_HPP
@@ -1,28 +1,242 @@
 // Local lib includes
 #include "PathFinder.hpp"
+#include "CompressedPath.hpp"
+#include "ContractionHierarchy.hpp"
+#include "MapRenderer.hpp"
 #include "PathFinderConstants.hpp"
+#include "Snapshot.hpp"
+#include "Tracer.hpp"
 
 // External lib includes
 #include <nlohmann/json.hpp> // Include nlohmann JSON library
 
 // Standard Includes
+#include <algorithm>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <optional>
+#include <numeric>
 #include <queue>
+#include <sstream>
 #include <stdexcept>
 #include <unordered_set>
 using json = nlohmann::json;
 using namespace PathPlanner;
 using Position = PathPlanner::PathFinder::Position;
 
+namespace
+{
+// Bump whenever the layout of a snapshot section or the content of a precomputed structure changes
+constexpr uint32_t SnapshotFormatVersion = 4;
+
+template <typename T> void writeValue(std::ostream &stream, const T &value)
+{
+    stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T> T readValue(std::istream &stream)
+{
+    T value{};
+    stream.read(reinterpret_cast<char *>(&value), sizeof(T));
+    if (!stream)
+    {
+        throw std::runtime_error("Unexpected end of snapshot section");
+    }
+    return value;
+}
+
+void writeComponents(std::ostream &stream, const PathFinder::ComponentLabels &components)
+{
+    components.labels.Serialize(stream);
+    writeValue<uint32_t>(stream, static_cast<uint32_t>(components.roots.size()));
+    for (int root : components.roots)
+    {
+        writeValue<int32_t>(stream, root);
+    }
+}
+
+std::shared_ptr<const PathFinder::ComponentLabels> readComponents(std::istream &stream,
+                                                                  const ChunkedGrid &map)
+{
+    auto components = std::make_shared<PathFinder::ComponentLabels>();
+    components->labels = ChunkedGrid::Deserialize(stream);
+    components->roots.resize(readValue<uint32_t>(stream));
+    for (int &root : components->roots)
+    {
+        root = readValue<int32_t>(stream);
+    }
+    if (components->labels.Rows() != map.Rows() || components->labels.Cols() != map.Cols())
+    {
+        throw std::runtime_error("Component labels do not match the grid dimensions");
+    }
+    return components;
+}
+
+// Passability of the configured movement classes from the named layers of a JSON map. Each layer is
+// read once and marks the cells it blocks for every class, the blocking values of the first layer
+// are kept to be checked against the map instead
+template <typename Rule>
+std::vector<PathFinder::MovementClass> parseMovementClasses(const json &layers,
+                                                            const std::vector<Rule> &rules,
+                                                            size_t cellCount)
+{
+    std::vector<PathFinder::MovementClass> classes(rules.size());
+    std::vector<std::vector<uint64_t>> blockedCells(rules.size(),
+                                                    std::vector<uint64_t>((cellCount + 63) / 64));
+    std::vector<size_t> matchedLayers(rules.size(), 0);
+    for (size_t layer = 0; layer < layers.size(); ++layer)
+    {
+        const std::string name = layers[layer].value(LayerName, std::string());
+        std::vector<int> cells;
+        for (size_t rule = 0; rule < rules.size(); ++rule)
+        {
+            for (const auto &[layerName, values] : rules[rule].blockedValues)
+            {
+                if (layerName != name)
+                {
+                    continue;
+                }
+                ++matchedLayers[rule];
+                if (layer == 0)
+                {
+                    classes[rule].blockedTerrain = values;
+                    continue;
+                }
+                if (cells.empty())
+                {
+                    cells = layers[layer].at(Data).get<std::vector<int>>();
+                    if (cells.size() < cellCount)
+                    {
+                        throw std::runtime_error("Layer " + name + " is smaller than the map");
+                    }
+                }
+                for (size_t index = 0; index < cellCount; ++index)
+                {
+                    if (std::find(values.begin(), values.end(), cells[index]) != values.end())
+                    {
+                        blockedCells[rule][index / 64] |= uint64_t(1) << (index % 64);
+                    }
+                }
+            }
+        }
+    }
+
+    for (size_t rule = 0; rule < rules.size(); ++rule)
+    {
+        if (matchedLayers[rule] != rules[rule].blockedValues.size())
+        {
+            throw std::runtime_error("Movement class " + rules[rule].name +
+                                     " refers to a missing layer");
+        }
+        classes[rule].blockedCells =
+            std::make_shared<const std::vector<uint64_t>>(std::move(blockedCells[rule]));
+    }
+    return classes;
+}
+
+// Versions of every shared map by source tag. Entries expire once no instance uses them anymore
+std::mutex sharedVersionsMutex;
+std::unordered_map<uint64_t, std::weak_ptr<const PathFinder::MapVersion>> sharedVersions;
+
+// Cells from the start of a search to the given node. The parent chain is counted first so the
+// path is written in order into a single allocation
+std::vector<Position> unwindPath(const PathFinder::Node &target)
+{
+    size_t length = 0;
+    for (const PathFinder::Node *node = &target; node != nullptr; node = node->parent)
+    {
+        ++length;
+    }
+    std::vector<Position> path(length);
+    for (const PathFinder::Node *node = &target; node != nullptr; node = node->parent)
+    {
+        path[--length] = node->pos;
+    }
+    return path;
+}
+} // namespace
+
 /**
- * @brief Constructor for the PathFinder Class. Parses config file and map file
+ * @brief Constructor for the PathFinder Class. Parses config file and map file, or reuses the map
+ * version of another instance loaded from the same inputs when map sharing is enabled
  */
 PathFinder::PathFinder(const std::string &configFilePath)
-    : m_targetPositions({}), m_startPositions({}), m_map({})
 {
+    TraceSpan span("PathFinder::PathFinder");
     parseConfig(configFilePath);
-    parseMap(m_mapFilePath);
+
+    const bool isChunkFile = m_mapFilePath.ends_with(ChunkFileExtension);
+    if (!m_movementClassRules.empty() &&
+        (isChunkFile || m_mapFilePath.ends_with(MovingAIMapExtension)))
+    {
+        std::cerr << "Config error at file: " << __FILE__ << ", line: " << __LINE__ << std::endl;
+        throw std::runtime_error("Movement classes need a JSON map with named layers");
+    }
+    uint64_t sourceTag = 0;
+    if (m_shareMap || (!m_snapshotFilePath.empty() && !isChunkFile))
+    {
+        sourceTag = computeSourceTag();
+    }
+    if (m_shareMap)
+    {
+        std::lock_guard<std::mutex> lock(sharedVersionsMutex);
+        auto shared = sharedVersions.find(sourceTag);
+        if (shared != sharedVersions.end())
+        {
+            if (auto version = shared->second.lock())
+            {
+                m_version.store(std::move(version));
+                m_sharingMap = true;
+                std::cout << "Sharing map with another instance" << std::endl;
+                return;
+            }
+        }
+    }
+
+    auto version = std::make_shared<MapVersion>();
+    if (isChunkFile)
+    {
+        // Chunk files already load lazily and are not snapshotted
+        parseChunkFile(m_mapFilePath, *version);
+    }
+    else if (m_snapshotFilePath.empty() || !loadSnapshot(sourceTag, *version))
+    {
+        if (m_mapFilePath.ends_with(MovingAIMapExtension))
+        {
+            parseMovingAIMap(m_mapFilePath, *version);
+        }
+        else
+        {
+            parseMap(m_mapFilePath, *version);
+        }
+        version->componentLabels =
+            std::make_shared<const ComponentLabels>(labelComponents(*version, 0));
+        for (size_t i = 0; i < version->movementClasses.size(); ++i)
+        {
+            version->movementClasses[i].components = std::make_shared<const ComponentLabels>(
+                labelComponents(*version, static_cast<int>(i) + 1));
+        }
+        version->clearance = std::make_shared<const ChunkedGrid>(computeClearance(version->map));
+    }
+
+    // The version is not visible to other threads before it is registered for sharing
+    m_version.store(version);
+    if (m_buildContractionHierarchy && !version->contractionHierarchy)
+    {
+        version->contractionHierarchy = std::make_shared<ContractionHierarchy>(*this);
+    }
+    if (!isChunkFile && !m_snapshotFilePath.empty() && !m_loadedFromSnapshot)
+    {
+        saveSnapshot(sourceTag, *version);
+    }
+    if (m_shareMap)
+    {
+        std::lock_guard<std::mutex> lock(sharedVersionsMutex);
+        sharedVersions[sourceTag] = version;
+    }
 }
 
 /**
@@ -30,9 +244,7 @@ PathFinder::PathFinder(const std::string &configFilePath)
  */
 PathFinder::~PathFinder()
 {
-    m_targetPositions.clear();
-    m_startPositions.clear();
-    m_map.clear();
+    m_version.store(nullptr);
     m_terrainKeys.clear();
     m_mapFilePath.clear();
 }
@@ -46,6 +258,7 @@ PathFinder::~PathFinder()
  */
 void PathFinder::parseConfig(const std::string &configFile)
 {
+    TraceSpan span("parseConfig");
     try
     {
         std::cout << "Parsing config file" << std::endl;
@@ -113,6 +326,71 @@ void PathFinder::parseConfig(const std::string &configFile)
                       << std::endl;
             throw std::runtime_error("Map file path not specified in config.");
         }
+
+        // Optional chunk layout and memory cap for lazily loaded chunk files
+        if (configJson.contains(ChunkSize))
+        {
+            m_chunkSize = configJson.at(ChunkSize).get<int>();
+            if (m_chunkSize <= 0)
+            {
+                std::cerr << "JSON parsing error at file: " << __FILE__ << ", line: " << __LINE__
+                          << std::endl;
+                throw std::runtime_error("Chunk size must be positive.");
+            }
+        }
+        if (configJson.contains(ChunkMemoryLimit))
+        {
+            m_chunkMemoryLimit = configJson.at(ChunkMemoryLimit).get<size_t>();
+        }
+
+        // Optional snapshot of the parsed map and precomputed structures for fast warm starts
+        if (configJson.contains(SnapshotFile))
+        {
+            m_snapshotFilePath = configJson.at(SnapshotFile).get<std::string>();
+        }
+
+        // Optional rendering settings, solved paths are written to imageFile after FindPaths
+        if (configJson.contains(Headless))
+        {
+            m_headless = configJson.at(Headless).get<bool>();
+        }
+        if (configJson.contains(ImageFile))
+        {
+            m_imageFilePath = configJson.at(ImageFile).get<std::string>();
+        }
+
+        // Optional run length encoded path output, see CompressedPath
+        if (configJson.contains(CompressPaths))
+        {
+            m_compressPaths = configJson.at(CompressPaths).get<bool>();
+        }
+
+        // Optional preprocessing for maps that never change, see ContractionHierarchy
+        if (configJson.contains(BuildContractionHierarchy))
+        {
+            m_buildContractionHierarchy = configJson.at(BuildContractionHierarchy).get<bool>();
+        }
+
+        // Instances loading the same inputs share the parsed map, e.g. many matches on one map,
+        // unless it is switched off
+        if (configJson.contains(ShareMap))
+        {
+            m_shareMap = configJson.at(ShareMap).get<bool>();
+        }
+
+        // Optional movement classes, each blocking cells by their values on named map layers
+        if (configJson.contains(MovementClasses))
+        {
+            for (const auto &[name, layers] : configJson.at(MovementClasses).items())
+            {
+                MovementClassRule rule{name, {}};
+                for (const auto &[layer, values] : layers.items())
+                {
+                    rule.blockedValues.emplace_back(layer, values.get<std::vector<int>>());
+                }
+                m_movementClassRules.push_back(std::move(rule));
+            }
+        }
     }
     catch (const nlohmann::json::exception &e)
     {
@@ -136,8 +414,9 @@ void PathFinder::parseConfig(const std::string &configFile)
  * @param mapFile File path to the map file
  *
  */
-void PathFinder::parseMap(const std::string &mapFile)
+void PathFinder::parseMap(const std::string &mapFile, MapVersion &version)
 {
+    TraceSpan span("parseMap");
     try
     {
         std::cout << "Parsing map data file" << std::endl;
@@ -158,9 +437,6 @@ void PathFinder::parseMap(const std::string &mapFile)
             width = mapJson[Tilesets][0][TileWidth];
 
             height = mapJson[Tilesets][0][TileHeight];
-
-            // Convert 1D map data to 2D
-            m_map.resize(height, std::vector<int>(width));
         }
         else
         {
@@ -181,27 +457,34 @@ void PathFinder::parseMap(const std::string &mapFile)
                 // Process the data here
                 std::cout << "Data found in first layer!" << std::endl;
 
+                std::vector<int> cells(static_cast<size_t>(width) * height);
                 for (int i = 0; i < height; ++i)
                 {
                     for (int j = 0; j < width; ++j)
                     {
                         Position startPosition, targetPosition;
                         int index = i * width + j;
-                        m_map[i][j] = int(data[index]);
-                        if (m_map[i][j] == m_terrainKeys[Start])
+                        int value = int(data[index]);
+                        cells[index] = value;
+                        if (value == m_terrainKeys[Start])
                         {
                             startPosition = {i, j};
-                            m_startPositions.push_back(startPosition);
+                            version.startPositions.push_back(startPosition);
                             std::cout << "Start Position " << i << " ," << j << std::endl;
                         }
-                        else if (m_map[i][j] == m_terrainKeys[Target])
+                        else if (value == m_terrainKeys[Target])
                         {
                             targetPosition = {i, j};
-                            m_targetPositions.push_back(targetPosition);
+                            version.targetPositions.push_back(targetPosition);
                             std::cout << "Target Position " << i << " ," << j << std::endl;
                         }
                     }
                 }
+
+                // Chunks with a single terrain value share one immutable instance
+                version.map = ChunkedGrid(height, width, cells, m_chunkSize);
+                version.movementClasses =
+                    parseMovementClasses(layers, m_movementClassRules, cells.size());
             }
             else{
                 std::cerr << "JSON parsing error at file: " << __FILE__ << ", line: " << __LINE__
@@ -216,9 +499,12 @@ void PathFinder::parseMap(const std::string &mapFile)
             throw std::runtime_error("Missing Layer field in Map");
         }
 
-        validateMapPositions();
+        validateMapPositions(version);
         std::cout << "Map is parsed" << std::endl;
-        printMap();
+        if (!m_headless)
+        {
+            printMap(version);
+        }
     }
     catch (const nlohmann::json::exception &e)
     {
@@ -236,181 +522,1011 @@ void PathFinder::parseMap(const std::string &mapFile)
 }
 
 /**
- * @brief Validate start and target positions specified on the map. Check for number of each and if
- * any of them are already on an obstacle
+ * @brief Parse a grid in the Moving AI benchmark format: a header with the type, height and width
+ * followed by "map" and one line of characters per row. '.', 'G' and 'S' are traversable and mapped
+ * to the reachable terrain key, every other character ('@', 'O', 'T', 'W') to the elevated key. The
+ * format has no units, so the map starts without start and target positions
+ *
+ * @param mapFile File path to the .map file
  *
  */
-void PathFinder::validateMapPositions()
+void PathFinder::parseMovingAIMap(const std::string &mapFile, MapVersion &version)
 {
-    size_t len1 = m_startPositions.size();
-    size_t len2 = m_targetPositions.size();
-
-    if (len1 > len2)
+    TraceSpan span("parseMovingAIMap");
+    std::cout << "Parsing Moving AI map file" << std::endl;
+    std::ifstream file(mapFile);
+    if (!file.is_open())
     {
-        // If there are lesser target positions than starting positions , duplicate the last target
-        // position till it matches the start positions size
-        auto lastTarget = m_targetPositions.back();
-        m_targetPositions.insert(m_targetPositions.end(), len1 - len2, lastTarget);
+        std::cerr << "Map parsing error at file: " << __FILE__ << ", line: " << __LINE__
+                  << std::endl;
+        throw std::runtime_error("Failed to open map file: " + mapFile);
     }
-    else if (len1 < len2)
+
+    int height = -1, width = -1;
+    std::string key;
+    while (file >> key && key != "map")
     {
-        // If there are lesser starting positions than target positions, trim the start positions
-        // vector to have 1:1 co-relation
-        m_targetPositions.resize(len1);
+        if (key == "height")
+        {
+            file >> height;
+        }
+        else if (key == "width")
+        {
+            file >> width;
+        }
+        else
+        {
+            // The type line, always octile for grid maps
+            std::string value;
+            file >> value;
+        }
     }
-}
-
-/**
- * @brief Allows calling applications to access Start position of particular unit
- *
- * @param index Access start position of that particular unit
- *
- */
-Position PathFinder::GetStartPosition(int index) const
-{
-    if (index >= 0 && index < m_startPositions.size())
+    if (key != "map" || height <= 0 || width <= 0)
     {
-        return m_startPositions[index];
+        std::cerr << "Map parsing error at file: " << __FILE__ << ", line: " << __LINE__
+                  << std::endl;
+        throw std::runtime_error("Missing or invalid header in map file: " + mapFile);
     }
-    else
+
+    const int reachable = m_terrainKeys.at(Reachable);
+    const int elevated = m_terrainKeys.at(Elevated);
+    std::vector<int> cells(static_cast<size_t>(width) * height);
+    std::string row;
+    for (int i = 0; i < height; ++i)
     {
-        throw std::out_of_range("Index out of bounds");
+        if (!(file >> row) || row.size() != static_cast<size_t>(width))
+        {
+            std::cerr << "Map parsing error at file: " << __FILE__ << ", line: " << __LINE__
+                      << std::endl;
+            throw std::runtime_error("Map row " + std::to_string(i) + " does not match the width");
+        }
+        for (int j = 0; j < width; ++j)
+        {
+            const char tile = row[j];
+            cells[static_cast<size_t>(i) * width + j] =
+                (tile == '.' || tile == 'G' || tile == 'S') ? reachable : elevated;
+        }
     }
+
+    version.map = ChunkedGrid(height, width, cells, m_chunkSize);
+    std::cout << "Map is parsed" << std::endl;
 }
 
 /**
- * @brief Allows calling applications to access Target position of particular unit
+ * @brief Open a chunk file produced by ExportChunkFile. Only the chunk table and the start and
+ * target markers are read, chunk data is decoded on first access and evicted under the configured
+ * memory limit
  *
- * @param index Access target position of that particular unit
+ * @param chunkFile File path to the chunk file
  *
  */
-Position PathFinder::GetTargetPosition(int index) const
+void PathFinder::parseChunkFile(const std::string &chunkFile, MapVersion &version)
 {
-    if (index >= 0 && index < m_targetPositions.size())
+    TraceSpan span("parseChunkFile");
+    try
     {
-        return m_targetPositions[index];
+        std::cout << "Opening chunked map file" << std::endl;
+        std::vector<ChunkedGrid::Marker> markers;
+        version.map = ChunkedGrid::OpenChunkFile(chunkFile, m_chunkMemoryLimit, &markers);
+
+        // Markers are stored in row major order, matching the order parseMap discovers them in
+        for (const auto &marker : markers)
+        {
+            if (marker.value == m_terrainKeys[Start])
+            {
+                version.startPositions.push_back({marker.x, marker.y});
+            }
+            else if (marker.value == m_terrainKeys[Target])
+            {
+                version.targetPositions.push_back({marker.x, marker.y});
+            }
+        }
+
+        validateMapPositions(version);
+        std::cout << "Map is parsed" << std::endl;
     }
-    else
+    catch (const std::exception &e)
     {
-        throw std::out_of_range("Index out of bounds");
+        std::cerr << "Error: " << e.what() << "\n"
+                  << "Error occurred at file: " << __FILE__ << ", line: " << __LINE__ << std::endl;
+        throw std::runtime_error("STD Error in parseChunkFile function.");
     }
 }
 
 /**
- * @brief Checks if the given Position exists within the bounds of a map and is reachable
- *
- * @param pos is an instance of the Position struct used to defined x and y positions in a 2D Map
+ * @brief Write the parsed map to a chunk file that can be used as the map file of later runs. Start
+ * and target positions are stored alongside so the map never has to be scanned in full
  *
- * @return bool true if position is valid, false if position is out of bounds or on an obstactle
+ * @param chunkFilePath Destination path, should end with the chunk file extension
  *
  */
-bool PathFinder::isValidPosition(const Position &pos) const
+void PathFinder::ExportChunkFile(const std::string &chunkFilePath) const
 {
-    const int elevated = m_terrainKeys.at(Elevated);
-    return pos.x >= 0 && pos.x < m_map.size() && pos.y >= 0 && pos.y < m_map[0].size() &&
-           m_map[pos.x][pos.y] != elevated;
+    const ChunkedGrid map = GetMap();
+    std::vector<ChunkedGrid::Marker> markers;
+    for (int x = 0; x < map.Rows(); ++x)
+    {
+        for (int y = 0; y < map.Cols(); ++y)
+        {
+            int value = map.At(x, y);
+            if (value == m_terrainKeys.at(Start) || value == m_terrainKeys.at(Target))
+            {
+                markers.push_back({value, x, y});
+            }
+        }
+    }
+    map.WriteChunkFile(chunkFilePath, markers);
 }
 
 /**
- * @brief Compute the Manhattan distance between two points in a two dimensional map. Used as the
- * heuristic for the A* algorithm
+ * @brief Compute the tag identifying the inputs a snapshot is built from: the map file content, the
+ * terrain keys, the chunk size and the snapshot format version
  *
- * @param a,b are both instances of the Position struct providing the two positions in the 2D Map
+ * @return uint64_t hash of all inputs
  *
- * @return int providing the Manhattan distance between the two points
  */
-int PathFinder::manhattanDistance(Position a, Position b) const
+uint64_t PathFinder::computeSourceTag() const
 {
-    return abs(a.x - b.x) + abs(a.y - b.y);
-}
+    uint64_t tag = Snapshot::HashBytes(&SnapshotFormatVersion, sizeof(SnapshotFormatVersion));
+    if (m_mapFilePath.ends_with(ChunkFileExtension))
+    {
+        // Chunk files are only tagged for map sharing, so their size and modification time stand
+        // in for the content, which may be far larger than memory
+        const auto size = std::filesystem::file_size(m_mapFilePath);
+        const auto modified =
+            std::filesystem::last_write_time(m_mapFilePath).time_since_epoch().count();
+        tag = Snapshot::HashBytes(m_mapFilePath.data(), m_mapFilePath.size(), tag);
+        tag = Snapshot::HashBytes(&size, sizeof(size), tag);
+        tag = Snapshot::HashBytes(&modified, sizeof(modified), tag);
+        tag = Snapshot::HashBytes(&m_chunkMemoryLimit, sizeof(m_chunkMemoryLimit), tag);
+    }
+    else
+    {
+        tag = Snapshot::HashFile(m_mapFilePath, tag);
+    }
 
-/**
- * @brief Used to identify if a position on the map has collision with any of the other units
- *
- * @param positions is a vector of current position of all the units.
- *        newPosition is the target position being checked for collision. This is generally one of
- * the neighbors of a chosen node currentIndex of the unit being checked for. Used to skip for
- * checking collision against the same unit in the iteration
- *
- * @return bool return true if collision is detected with another unit, return false if no collision
- * is detected
- *
- */
-bool PathFinder::hasCollision(const std::vector<Position> &positions, const Position &newPosition,
-                              size_t currentIndex) const
-{
-    for (size_t i = 0; i < positions.size(); ++i)
+    // Terrain keys are hashed in name order so the tag does not depend on hash map iteration
+    const std::map<std::string, int> sortedKeys(m_terrainKeys.begin(), m_terrainKeys.end());
+    for (const auto &[key, value] : sortedKeys)
     {
-        if (i != currentIndex && positions[i] == newPosition)
+        tag = Snapshot::HashBytes(key.data(), key.size(), tag);
+        tag = Snapshot::HashBytes(&value, sizeof(value), tag);
+    }
+    for (const auto &rule : m_movementClassRules)
+    {
+        tag = Snapshot::HashBytes(rule.name.data(), rule.name.size(), tag);
+        for (const auto &[layer, values] : rule.blockedValues)
         {
-            return true;
+            tag = Snapshot::HashBytes(layer.data(), layer.size(), tag);
+            tag = Snapshot::HashBytes(values.data(), values.size() * sizeof(int), tag);
         }
     }
-    return false;
+    tag = Snapshot::HashBytes(&m_buildContractionHierarchy, sizeof(m_buildContractionHierarchy), tag);
+    return Snapshot::HashBytes(&m_chunkSize, sizeof(m_chunkSize), tag);
 }
 
 /**
- * @brief Find Paths is the core logic of this class. It implements A* search algorithm for all
- * units in the map. It ensures each unit moves by one step in each iteration and paths are updates
- * till all units reach their targets. It reconstructs the paths after the units have reached their
- * targets
+ * @brief Restore the parsed map and precomputed structures from the configured snapshot
+ *
+ * @param sourceTag Tag of the current inputs, snapshots with a different tag are ignored
+ *
+ * @return bool true if the snapshot was loaded, false if it is missing, stale or incomplete
  *
  */
-void PathFinder::FindPaths()
+bool PathFinder::loadSnapshot(uint64_t sourceTag, MapVersion &version)
 {
-    // Initialize current positions for all units
-    std::vector<std::priority_queue<Node, std::vector<Node>, std::greater<Node>>> openLists(
-        m_startPositions.size());
-    std::vector<std::unordered_map<Position, Node>> allNodes(m_startPositions.size());
-    std::vector<std::unordered_set<Position>> closedLists(m_startPositions.size());
-    std::vector<std::vector<Position>> paths(
-        m_startPositions.size()); // Vector of paths for each unit
-    std::vector<bool> reachedTargets(m_startPositions.size(),
-                                     false); // Track which units have reached their targets
-    std::vector<Position> currentPositions =
-        m_startPositions; // Track current positions of all units
-
-    // Initialize each unit's open list with its start node
-    for (size_t i = 0; i < m_startPositions.size(); ++i)
+    TraceSpan span("loadSnapshot");
+    std::optional<Snapshot> snapshot = Snapshot::Load(m_snapshotFilePath, sourceTag);
+    const std::string *grid = snapshot ? snapshot->GetSection(Snapshot::Section::Grid) : nullptr;
+    const std::string *positions =
+        snapshot ? snapshot->GetSection(Snapshot::Section::Positions) : nullptr;
+    const std::string *labels =
+        snapshot ? snapshot->GetSection(Snapshot::Section::ComponentLabels) : nullptr;
+    const std::string *clearance =
+        snapshot ? snapshot->GetSection(Snapshot::Section::Clearance) : nullptr;
+    const std::string *hierarchy =
+        snapshot ? snapshot->GetSection(Snapshot::Section::ContractionHierarchy) : nullptr;
+    const std::string *movementClasses =
+        snapshot ? snapshot->GetSection(Snapshot::Section::MovementClasses) : nullptr;
+    if (!grid || !positions || !labels || !clearance ||
+        (m_buildContractionHierarchy && !hierarchy) ||
+        (!m_movementClassRules.empty() && !movementClasses))
     {
-        Node startNode(m_startPositions[i], 0,
-                       manhattanDistance(m_startPositions[i], m_targetPositions[i]), nullptr);
-        allNodes[i][m_startPositions[i]] = startNode;
-        openLists[i].push(startNode);
+        std::cout << "No matching snapshot, parsing map" << std::endl;
+        return false;
     }
 
-    bool allReached = false;
-
-    while (!allReached)
+    try
     {
-        allReached = true;
+        std::istringstream gridStream(*grid);
+        ChunkedGrid map = ChunkedGrid::Deserialize(gridStream);
 
-        for (size_t i = 0; i < m_startPositions.size(); ++i)
+        std::istringstream positionStream(*positions);
+        std::vector<Position> startPositions, targetPositions;
+        for (auto *list : {&startPositions, &targetPositions})
         {
-            if (reachedTargets[i])
-            {
-                // Skip this robot as it has already reached its target
-                continue;
-            }
-
-            if (openLists[i].empty())
+            list->resize(readValue<uint32_t>(positionStream));
+            for (auto &pos : *list)
             {
-                continue;
+                pos.x = readValue<int32_t>(positionStream);
+                pos.y = readValue<int32_t>(positionStream);
             }
+        }
 
-            Node currentNode = openLists[i].top();
-            openLists[i].pop();
+        std::istringstream labelStream(*labels);
+        auto componentLabels = readComponents(labelStream, map);
 
-            if (currentNode.pos == m_targetPositions[i])
+        std::istringstream clearanceStream(*clearance);
+        auto clearanceValues =
+            std::make_shared<const ChunkedGrid>(ChunkedGrid::Deserialize(clearanceStream));
+        if (clearanceValues->Rows() != map.Rows() || clearanceValues->Cols() != map.Cols())
+        {
+            throw std::runtime_error("Clearance does not match the grid dimensions");
+        }
+
+        std::shared_ptr<const ContractionHierarchy> contractionHierarchy;
+        if (m_buildContractionHierarchy)
+        {
+            std::istringstream hierarchyStream(*hierarchy);
+            contractionHierarchy = std::make_shared<const ContractionHierarchy>(
+                ContractionHierarchy::Deserialize(hierarchyStream));
+        }
+
+        std::vector<MovementClass> classes(m_movementClassRules.size());
+        if (!classes.empty())
+        {
+            std::istringstream classStream(*movementClasses);
+            for (auto &movementClass : classes)
+            {
+                movementClass.blockedTerrain.resize(readValue<uint32_t>(classStream));
+                for (int &value : movementClass.blockedTerrain)
+                {
+                    value = readValue<int32_t>(classStream);
+                }
+                auto blockedCells = std::make_shared<std::vector<uint64_t>>(
+                    (static_cast<size_t>(map.Rows()) * map.Cols() + 63) / 64);
+                for (uint64_t &word : *blockedCells)
+                {
+                    word = readValue<uint64_t>(classStream);
+                }
+                movementClass.blockedCells = std::move(blockedCells);
+                movementClass.components = readComponents(classStream, map);
+            }
+        }
+
+        version.map = std::move(map);
+        version.startPositions = std::move(startPositions);
+        version.targetPositions = std::move(targetPositions);
+        version.componentLabels = std::move(componentLabels);
+        version.clearance = std::move(clearanceValues);
+        version.contractionHierarchy = std::move(contractionHierarchy);
+        version.movementClasses = std::move(classes);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Discarding corrupt snapshot: " << e.what() << std::endl;
+        return false;
+    }
+
+    m_loadedFromSnapshot = true;
+    std::cout << "Map is loaded from snapshot" << std::endl;
+    if (!m_headless)
+    {
+        printMap(version);
+    }
+    return true;
+}
+
+/**
+ * @brief Write the parsed map and precomputed structures to the configured snapshot file
+ *
+ * @param sourceTag Tag of the inputs the structures were built from
+ *
+ */
+void PathFinder::saveSnapshot(uint64_t sourceTag, const MapVersion &version) const
+{
+    TraceSpan span("saveSnapshot");
+    Snapshot snapshot(sourceTag);
+
+    std::ostringstream gridStream;
+    version.map.Serialize(gridStream);
+    snapshot.SetSection(Snapshot::Section::Grid, gridStream.str());
+
+    std::ostringstream positionStream;
+    for (const auto *list : {&version.startPositions, &version.targetPositions})
+    {
+        writeValue<uint32_t>(positionStream, static_cast<uint32_t>(list->size()));
+        for (const auto &pos : *list)
+        {
+            writeValue<int32_t>(positionStream, pos.x);
+            writeValue<int32_t>(positionStream, pos.y);
+        }
+    }
+    snapshot.SetSection(Snapshot::Section::Positions, positionStream.str());
+
+    std::ostringstream labelStream;
+    writeComponents(labelStream, *version.componentLabels);
+    snapshot.SetSection(Snapshot::Section::ComponentLabels, labelStream.str());
+
+    std::ostringstream clearanceStream;
+    version.clearance->Serialize(clearanceStream);
+    snapshot.SetSection(Snapshot::Section::Clearance, clearanceStream.str());
+    if (version.contractionHierarchy)
+    {
+        std::ostringstream hierarchyStream;
+        version.contractionHierarchy->Serialize(hierarchyStream);
+        snapshot.SetSection(Snapshot::Section::ContractionHierarchy, hierarchyStream.str());
+    }
+    if (!version.movementClasses.empty())
+    {
+        std::ostringstream classStream;
+        for (const auto &movementClass : version.movementClasses)
+        {
+            writeValue<uint32_t>(classStream,
+                                 static_cast<uint32_t>(movementClass.blockedTerrain.size()));
+            for (int value : movementClass.blockedTerrain)
+            {
+                writeValue<int32_t>(classStream, value);
+            }
+            for (uint64_t word : *movementClass.blockedCells)
+            {
+                writeValue<uint64_t>(classStream, word);
+            }
+            writeComponents(classStream, *movementClass.components);
+        }
+        snapshot.SetSection(Snapshot::Section::MovementClasses, classStream.str());
+    }
+
+    try
+    {
+        snapshot.Save(m_snapshotFilePath);
+    }
+    catch (const std::exception &e)
+    {
+        // A missing snapshot only costs start up time, so failing to write one is not fatal
+        std::cerr << "Failed to save snapshot: " << e.what() << std::endl;
+    }
+}
+
+/**
+ * @brief Label the connected components of the cells a single cell unit can pass with a flood fill
+ *
+ * @param version Map version to label, its movement class bitmaps must be complete
+ * @param movementClass Passability rules to label for, 0 for the terrain keys
+ *
+ * @return ComponentLabels of every cell, each component being its own root
+ *
+ */
+PathFinder::ComponentLabels PathFinder::labelComponents(const MapVersion &version,
+                                                        int movementClass) const
+{
+    TraceSpan span("labelComponents");
+    const ChunkedGrid &map = version.map;
+    QueryOptions options;
+    options.movementClass = movementClass;
+    const int rows = map.Rows();
+    const int cols = map.Cols();
+    std::vector<int> labels(static_cast<size_t>(rows) * cols, -1);
+    int nextLabel = 0;
+
+    for (int x = 0; x < rows; ++x)
+    {
+        for (int y = 0; y < cols; ++y)
+        {
+            if (labels[static_cast<size_t>(x) * cols + y] != -1 ||
+                !isPassable(version, {x, y}, options))
+            {
+                continue;
+            }
+            std::queue<Position> frontier;
+            frontier.push({x, y});
+            labels[static_cast<size_t>(x) * cols + y] = nextLabel;
+            while (!frontier.empty())
+            {
+                Node current(frontier.front(), 0, 0, nullptr);
+                frontier.pop();
+                for (const auto &next : getNeighborsforCurrentNode(current))
+                {
+                    const size_t index = static_cast<size_t>(next.x) * cols + next.y;
+                    if (isPassable(version, next, options) && labels[index] == -1)
+                    {
+                        labels[index] = nextLabel;
+                        frontier.push(next);
+                    }
+                }
+            }
+            ++nextLabel;
+        }
+    }
+
+    ComponentLabels components{ChunkedGrid(rows, cols, labels, map.ChunkSize()),
+                               std::vector<int>(nextLabel)};
+    std::iota(components.roots.begin(), components.roots.end(), 0);
+    return components;
+}
+
+/**
+ * @brief Update the component labels after the traversability of a cell changed. A blocked cell
+ * loses its label, an opened cell joins the components of its neighbors and merges them by
+ * pointing their roots at one of them, or starts a new component
+ *
+ * @param version Map version after the change
+ * @param movementClass Passability rules the labels were built for, 0 for the terrain keys
+ * @param components Labels before the change, updated in place. Only the chunk of the cell and
+ * the root table are copied
+ * @param pos Cell whose terrain changed
+ *
+ */
+void PathFinder::updateComponents(const MapVersion &version, int movementClass,
+                                  ComponentLabels &components, const Position &pos) const
+{
+    QueryOptions options;
+    options.movementClass = movementClass;
+    if (!isPassable(version, pos, options))
+    {
+        components.labels.Set(pos.x, pos.y, -1);
+        return;
+    }
+
+    int label = -1;
+    for (const auto &neighbor : getNeighborsforCurrentNode(Node(pos, 0, 0, nullptr)))
+    {
+        if (!isPassable(version, neighbor, options))
+        {
+            continue;
+        }
+        const int neighborLabel = components.labels.At(neighbor.x, neighbor.y);
+        if (label == -1)
+        {
+            label = neighborLabel;
+            continue;
+        }
+        const int from = components.roots[neighborLabel];
+        const int to = components.roots[label];
+        if (from != to)
+        {
+            std::replace(components.roots.begin(), components.roots.end(), from, to);
+        }
+    }
+    if (label == -1)
+    {
+        label = static_cast<int>(components.roots.size());
+        components.roots.push_back(label);
+    }
+    components.labels.Set(pos.x, pos.y, label);
+}
+
+/**
+ * @brief Current map version. The returned version never changes and stays valid while it is held,
+ * even if the terrain is edited concurrently
+ *
+ * @return shared pointer to the current version
+ *
+ */
+std::shared_ptr<const PathFinder::MapVersion> PathFinder::GetMapVersion() const
+{
+    return m_version.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Check if a position is on the map and not blocked
+ *
+ */
+bool PathFinder::IsTraversable(const Position &pos) const
+{
+    return isValidPosition(GetMapVersion()->map, pos);
+}
+
+/**
+ * @brief Check whether a path between two positions exists, using the connected component labels
+ *
+ * @param a,b Positions to check
+ *
+ * @return bool true if both positions are traversable and in the same connected component. After
+ * edits that blocked cells it may still be true for cells they separated, see ComponentLabels.
+ * Maps without component labels, i.e. chunk file maps, only check that both are traversable
+ *
+ */
+bool PathFinder::AreConnected(const Position &a, const Position &b) const
+{
+    return areConnected(*GetMapVersion(), a, b);
+}
+
+/**
+ * @brief Connectivity check against a specific map version
+ */
+bool PathFinder::areConnected(const MapVersion &version, const Position &a,
+                              const Position &b) const
+{
+    if (!isValidPosition(version.map, a) || !isValidPosition(version.map, b))
+    {
+        return false;
+    }
+    if (!version.componentLabels)
+    {
+        return true;
+    }
+    return version.componentLabels->RootAt(a) == version.componentLabels->RootAt(b);
+}
+
+/**
+ * @brief Compute the clearance of every cell with a single sweep from the bottom right corner. A
+ * traversable cell fits one more than the smallest square fitting at its right, lower and lower
+ * right neighbors
+ *
+ * @param map Grid to compute the clearance for
+ *
+ * @return ChunkedGrid clearance of every cell, chunked like the map
+ *
+ */
+ChunkedGrid PathFinder::computeClearance(const ChunkedGrid &map) const
+{
+    TraceSpan span("computeClearance");
+    const int rows = map.Rows();
+    const int cols = map.Cols();
+    std::vector<int> clearance(static_cast<size_t>(rows) * cols, 0);
+
+    auto at = [&](int x, int y) -> int
+    { return x < rows && y < cols ? clearance[static_cast<size_t>(x) * cols + y] : 0; };
+    for (int x = rows - 1; x >= 0; --x)
+    {
+        for (int y = cols - 1; y >= 0; --y)
+        {
+            if (isValidPosition(map, {x, y}))
+            {
+                clearance[static_cast<size_t>(x) * cols + y] =
+                    std::min(1 + std::min({at(x + 1, y), at(x, y + 1), at(x + 1, y + 1)}),
+                             MaxClearance);
+            }
+        }
+    }
+    return ChunkedGrid(rows, cols, clearance, map.ChunkSize());
+}
+
+/**
+ * @brief Update the clearance after the traversability of a cell changed. Only cells above and to
+ * the left within the clearance cap can depend on it, and rows are revisited upwards until one
+ * row is left unchanged
+ *
+ * @param map Grid after the change
+ * @param clearance Clearance before the change, updated in place. Only the chunks holding changed
+ * cells are copied
+ * @param pos Cell whose terrain changed
+ *
+ */
+void PathFinder::updateClearance(const ChunkedGrid &map, ChunkedGrid &clearance,
+                                 const Position &pos) const
+{
+    const int rows = map.Rows();
+    const int cols = map.Cols();
+    auto at = [&](int x, int y) -> int { return x < rows && y < cols ? clearance.At(x, y) : 0; };
+
+    const int firstCol = std::max(0, pos.y - MaxClearance + 1);
+    for (int x = pos.x; x >= std::max(0, pos.x - MaxClearance + 1); --x)
+    {
+        bool changed = false;
+        for (int y = pos.y; y >= firstCol; --y)
+        {
+            int fit = 0;
+            if (isValidPosition(map, {x, y}))
+            {
+                fit = std::min(1 + std::min({at(x + 1, y), at(x, y + 1), at(x + 1, y + 1)}),
+                               MaxClearance);
+            }
+            if (clearance.At(x, y) != fit)
+            {
+                clearance.Set(x, y, fit);
+                changed = true;
+            }
+        }
+        if (!changed)
+        {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Largest square unit that fits with its top left corner at a position
+ *
+ * @param pos Position to check
+ *
+ * @return int edge length of the square, 0 for blocked or out of bounds positions
+ *
+ */
+int PathFinder::GetClearance(const Position &pos) const
+{
+    const auto version = GetMapVersion();
+    if (pos.x < 0 || pos.x >= version->map.Rows() || pos.y < 0 || pos.y >= version->map.Cols())
+    {
+        return 0;
+    }
+    if (!version->clearance)
+    {
+        // Grow the square until it hits a blocked cell or the map edge
+        int size = 0;
+        while (size < MaxClearance && fitsUnit(*version, pos, size + 1))
+        {
+            ++size;
+        }
+        return size;
+    }
+    return version->clearance->At(pos.x, pos.y);
+}
+
+/**
+ * @brief Id of a movement class from the config for QueryOptions::movementClass
+ *
+ * @param name Name of the class in the movementClasses config object
+ *
+ * @return int id of the class, ids start at 1 since 0 plans with the terrain keys. Throws
+ * std::invalid_argument for unknown names
+ *
+ */
+int PathFinder::GetMovementClass(const std::string &name) const
+{
+    for (size_t i = 0; i < m_movementClassRules.size(); ++i)
+    {
+        if (m_movementClassRules[i].name == name)
+        {
+            return static_cast<int>(i) + 1;
+        }
+    }
+    throw std::invalid_argument("Unknown movement class: " + name);
+}
+
+/**
+ * @brief Check if a unit of the given size can stand with its top left corner at a position. Single
+ * cell units only need the terrain check, larger units the clearance map if the version has one
+ *
+ */
+bool PathFinder::fitsUnit(const MapVersion &version, const Position &pos, int unitSize) const
+{
+    if (unitSize <= 1)
+    {
+        return isValidPosition(version.map, pos);
+    }
+    if (pos.x < 0 || pos.x >= version.map.Rows() || pos.y < 0 || pos.y >= version.map.Cols())
+    {
+        return false;
+    }
+    if (!version.clearance)
+    {
+        if (pos.x + unitSize > version.map.Rows() || pos.y + unitSize > version.map.Cols())
+        {
+            return false;
+        }
+        for (int x = pos.x; x < pos.x + unitSize; ++x)
+        {
+            for (int y = pos.y; y < pos.y + unitSize; ++y)
+            {
+                if (!isValidPosition(version.map, {x, y}))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    return version.clearance->At(pos.x, pos.y) >= unitSize;
+}
+
+/**
+ * @brief Check if the unit of a query can stand with its top left corner at a position, under the
+ * passability rules of its movement class
+ *
+ */
+bool PathFinder::isPassable(const MapVersion &version, const Position &pos,
+                            const QueryOptions &options) const
+{
+    if (options.movementClass == 0)
+    {
+        return fitsUnit(version, pos, options.unitSize);
+    }
+    const MovementClass &movementClass = version.movementClasses[options.movementClass - 1];
+    if (pos.x < 0 || pos.x + options.unitSize > version.map.Rows() || pos.y < 0 ||
+        pos.y + options.unitSize > version.map.Cols())
+    {
+        return false;
+    }
+    for (int x = pos.x; x < pos.x + options.unitSize; ++x)
+    {
+        for (int y = pos.y; y < pos.y + options.unitSize; ++y)
+        {
+            const size_t index = static_cast<size_t>(x) * version.map.Cols() + y;
+            const int value = version.map.At(x, y);
+            if (((*movementClass.blockedCells)[index / 64] >> (index % 64)) & 1 ||
+                std::find(movementClass.blockedTerrain.begin(), movementClass.blockedTerrain.end(),
+                          value) != movementClass.blockedTerrain.end())
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Change the terrain of a cell at runtime, e.g. when a building is placed or destroyed. A new
+ * map version is built copy on write, sharing every unchanged chunk and derived structure with the
+ * current one, and published with an atomic swap. Searches that are already running keep using the
+ * version they started with. If the cell changed between traversable and blocked, the clearance
+ * map and component labels are updated incrementally, copying only the chunks they change, and a
+ * contraction hierarchy is dropped. Edits of instances sharing a map only affect the editing
+ * instance
+ *
+ * @param pos Cell to change
+ * @param value New terrain value
+ *
+ */
+void PathFinder::SetTerrain(const Position &pos, int value)
+{
+    TraceSpan span("SetTerrain");
+    std::lock_guard<std::mutex> lock(m_editMutex);
+    const auto current = GetMapVersion();
+    if (pos.x < 0 || pos.x >= current->map.Rows() || pos.y < 0 || pos.y >= current->map.Cols())
+    {
+        throw std::out_of_range("Terrain position out of bounds");
+    }
+
+    auto next = std::make_shared<MapVersion>();
+    next->map = current->map;
+    next->map.Set(pos.x, pos.y, value);
+    next->startPositions = current->startPositions;
+    next->targetPositions = current->targetPositions;
+    next->movementClasses = current->movementClasses;
+    next->revision = current->revision + 1;
+
+    // The passability of movement classes may change even if the traversability does not
+    for (size_t i = 0; i < next->movementClasses.size(); ++i)
+    {
+        MovementClass &movementClass = next->movementClasses[i];
+        QueryOptions options;
+        options.movementClass = static_cast<int>(i) + 1;
+        if (movementClass.components &&
+            isPassable(*next, pos, options) != isPassable(*current, pos, options))
+        {
+            auto updatedLabels = std::make_shared<ComponentLabels>(*movementClass.components);
+            updateComponents(*next, options.movementClass, *updatedLabels, pos);
+            movementClass.components = std::move(updatedLabels);
+        }
+    }
+
+    if (isValidPosition(next->map, pos) == isValidPosition(current->map, pos))
+    {
+        // Traversability is unchanged, so every derived structure can be shared
+        next->componentLabels = current->componentLabels;
+        next->clearance = current->clearance;
+        next->contractionHierarchy = current->contractionHierarchy;
+    }
+    else
+    {
+        // Maps without derived structures, i.e. chunk file maps, have nothing to update
+        if (current->clearance)
+        {
+            auto updatedClearance = std::make_shared<ChunkedGrid>(*current->clearance);
+            updateClearance(next->map, *updatedClearance, pos);
+            next->clearance = std::move(updatedClearance);
+        }
+        if (current->componentLabels)
+        {
+            auto updatedLabels = std::make_shared<ComponentLabels>(*current->componentLabels);
+            updateComponents(*next, 0, *updatedLabels, pos);
+            next->componentLabels = std::move(updatedLabels);
+        }
+        if (current->contractionHierarchy)
+        {
+            std::cout << "Terrain changed, contraction hierarchy disabled" << std::endl;
+        }
+    }
+    m_version.store(std::move(next), std::memory_order_release);
+}
+
+/**
+ * @brief Validate start and target positions specified on the map. Check for number of each and if
+ * any of them are already on an obstacle
+ *
+ */
+void PathFinder::validateMapPositions(MapVersion &version)
+{
+    TraceSpan span("validateMapPositions");
+    size_t len1 = version.startPositions.size();
+    size_t len2 = version.targetPositions.size();
+
+    if (len1 > len2)
+    {
+        // If there are lesser target positions than starting positions , duplicate the last target
+        // position till it matches the start positions size
+        auto lastTarget = version.targetPositions.back();
+        version.targetPositions.insert(version.targetPositions.end(), len1 - len2, lastTarget);
+    }
+    else if (len1 < len2)
+    {
+        // If there are lesser starting positions than target positions, trim the start positions
+        // vector to have 1:1 co-relation
+        version.targetPositions.resize(len1);
+    }
+}
+
+/**
+ * @brief Allows calling applications to access Start position of particular unit
+ *
+ * @param index Access start position of that particular unit
+ *
+ */
+Position PathFinder::GetStartPosition(int index) const
+{
+    const auto version = GetMapVersion();
+    if (index >= 0 && index < version->startPositions.size())
+    {
+        return version->startPositions[index];
+    }
+    else
+    {
+        throw std::out_of_range("Index out of bounds");
+    }
+}
+
+/**
+ * @brief Allows calling applications to access Target position of particular unit
+ *
+ * @param index Access target position of that particular unit
+ *
+ */
+Position PathFinder::GetTargetPosition(int index) const
+{
+    const auto version = GetMapVersion();
+    if (index >= 0 && index < version->targetPositions.size())
+    {
+        return version->targetPositions[index];
+    }
+    else
+    {
+        throw std::out_of_range("Index out of bounds");
+    }
+}
+
+/**
+ * @brief Checks if the given Position exists within the bounds of a map and is reachable
+ *
+ * @param map Map version to check against
+ * @param pos is an instance of the Position struct used to defined x and y positions in a 2D Map
+ *
+ * @return bool true if position is valid, false if position is out of bounds or on an obstactle
+ *
+ */
+bool PathFinder::isValidPosition(const ChunkedGrid &map, const Position &pos) const
+{
+    const int elevated = m_terrainKeys.at(Elevated);
+    return pos.x >= 0 && pos.x < map.Rows() && pos.y >= 0 && pos.y < map.Cols() &&
+           map.At(pos.x, pos.y) != elevated;
+}
+
+/**
+ * @brief Compute the Manhattan distance between two points in a two dimensional map. Used as the
+ * heuristic for the A* algorithm
+ *
+ * @param a,b are both instances of the Position struct providing the two positions in the 2D Map
+ *
+ * @return int providing the Manhattan distance between the two points
+ */
+int PathFinder::manhattanDistance(Position a, Position b) const
+{
+    return abs(a.x - b.x) + abs(a.y - b.y);
+}
+
+/**
+ * @brief Compute the octile distance between two points, the length of the shortest path with
+ * straight and diagonal moves on an empty map. Used as the A* heuristic of diagonal searches
+ *
+ * @param a,b Positions to measure between
+ *
+ * @return int distance in the fixed point move costs of diagonal searches
+ */
+int PathFinder::octileDistance(Position a, Position b) const
+{
+    const int dx = abs(a.x - b.x);
+    const int dy = abs(a.y - b.y);
+    return OctileDiagonalCost * std::min(dx, dy) +
+           OctileStraightCost * (std::max(dx, dy) - std::min(dx, dy));
+}
+
+/**
+ * @brief Used to identify if a position on the map has collision with any of the other units
+ *
+ * @param positions is a vector of current position of all the units.
+ *        newPosition is the target position being checked for collision. This is generally one of
+ * the neighbors of a chosen node currentIndex of the unit being checked for. Used to skip for
+ * checking collision against the same unit in the iteration
+ *
+ * @return bool return true if collision is detected with another unit, return false if no collision
+ * is detected
+ *
+ */
+bool PathFinder::hasCollision(const std::vector<Position> &positions, const Position &newPosition,
+                              size_t currentIndex) const
+{
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+        if (i != currentIndex && positions[i] == newPosition)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Find Paths is the core logic of this class. It implements A* search algorithm for all
+ * units in the map. It ensures each unit moves by one step in each iteration and paths are updates
+ * till all units reach their targets. It reconstructs the paths after the units have reached their
+ * targets
+ *
+ */
+void PathFinder::FindPaths()
+{
+    TraceSpan span("FindPaths");
+    // Units are planned against the version current at the start, edits apply to later calls
+    const auto version = GetMapVersion();
+    const std::vector<Position> &startPositions = version->startPositions;
+    const std::vector<Position> &targetPositions = version->targetPositions;
+    // Initialize current positions for all units
+    std::vector<std::priority_queue<Node, std::vector<Node>, std::greater<Node>>> openLists(
+        startPositions.size());
+    std::vector<std::unordered_map<Position, Node>> allNodes(startPositions.size());
+    std::vector<std::unordered_set<Position>> closedLists(startPositions.size());
+    std::vector<std::vector<Position>> paths(
+        m_compressPaths ? 0 : startPositions.size()); // Vector of paths for each unit
+    std::vector<CompressedPath> compressedPaths(m_compressPaths ? startPositions.size() : 0);
+    std::vector<bool> reachedTargets(startPositions.size(),
+                                     false); // Track which units have reached their targets
+    std::vector<Position> currentPositions =
+        startPositions; // Track current positions of all units
+
+    // Initialize each unit's open list with its start node
+    for (size_t i = 0; i < startPositions.size(); ++i)
+    {
+        Node startNode(startPositions[i], 0,
+                       manhattanDistance(startPositions[i], targetPositions[i]), nullptr);
+        allNodes[i][startPositions[i]] = startNode;
+        openLists[i].push(startNode);
+    }
+
+    bool allReached = false;
+
+    while (!allReached)
+    {
+        allReached = true;
+
+        for (size_t i = 0; i < startPositions.size(); ++i)
+        {
+            if (reachedTargets[i])
+            {
+                // Skip this robot as it has already reached its target
+                continue;
+            }
+
+            if (openLists[i].empty())
+            {
+                continue;
+            }
+
+            // One span per expansion step of each unit
+            TraceSpan unitSpan("ExpandUnit", "FindPaths", "unit", static_cast<int64_t>(i));
+            Node currentNode = openLists[i].top();
+            openLists[i].pop();
+
+            if (currentNode.pos == targetPositions[i])
             {
                 // Goal reached, reconstruct path
-                std::vector<Position> path;
-                for (const Node *node = &currentNode; node != nullptr; node = node->parent)
+                if (m_compressPaths)
                 {
-                    path.push_back(node->pos);
+                    compressedPaths[i] = CompressedPath::FromParentChain(&currentNode);
+                }
+                else
+                {
+                    paths[i] = unwindPath(currentNode);
                 }
-                std::reverse(path.begin(), path.end());
-                paths[i] = path;
 
                 std::cout << "Unit " << i << " has reached its target." << std::endl;
                 reachedTargets[i] = true;
@@ -425,14 +1541,14 @@ void PathFinder::FindPaths()
             for (const auto &neighbor : neighbors)
             {
                 // Skip invalid or already visited positions
-                if (!isValidPosition(neighbor) || closedLists[i].count(neighbor) ||
+                if (!isValidPosition(version->map, neighbor) || closedLists[i].count(neighbor) ||
                     hasCollision(currentPositions, neighbor, i))
                 {
                     continue;
                 }
 
                 int gCost = currentNode.gCost + 1;
-                int hCost = manhattanDistance(neighbor, m_targetPositions[i]);
+                int hCost = manhattanDistance(neighbor, targetPositions[i]);
                 Node neighborNode(neighbor, gCost, hCost, &allNodes[i][currentNode.pos]);
 
                 // Add new nodes or update existing ones if a better path is found
@@ -454,22 +1570,346 @@ void PathFinder::FindPaths()
         }
     }
 
-    printPaths(paths);
-    printMap(paths);
+    m_solvedPaths = std::move(paths);
+    m_compressedPaths = std::move(compressedPaths);
+    TraceSpan outputSpan("Output");
+    if (!m_headless)
+    {
+        printPaths();
+        printMap(*version);
+    }
+    if (!m_imageFilePath.empty())
+    {
+        ExportImage(m_imageFilePath);
+    }
+}
+
+/**
+ * @brief Plan a single path with A* independently of the units parsed from the map. The map is only
+ * read, so concurrent calls from several threads are safe
+ *
+ * @param start,target Start and target position of the query
+ * @param options Per query settings, shouldStop is polled every few hundred expansions,
+ * unitSize selects the footprint checked against the clearance map, allowDiagonal adds diagonal
+ * moves and isBlocked adds dynamic obstacles. Single cell 4-connected queries without dynamic
+ * obstacles are answered by the contraction hierarchy when one was built, unless
+ * useContractionHierarchy is unset
+ *
+ * @return vector<Position> path from start to target, empty if no path exists or the search was
+ * stopped
+ *
+ */
+std::vector<Position> PathFinder::FindPath(const Position &start, const Position &target,
+                                           const QueryOptions &options) const
+{
+    TraceSpan span("FindPath");
+    // The search keeps this version even if the terrain is edited meanwhile
+    const auto version = GetMapVersion();
+    if (!isPlannable(*version, start, target, options))
+    {
+        return {};
+    }
+    if (version->contractionHierarchy && options.useContractionHierarchy &&
+        options.unitSize <= 1 && !options.allowDiagonal && !options.isBlocked &&
+        options.movementClass == 0)
+    {
+        return version->contractionHierarchy->FindPath(start, target);
+    }
+
+    std::unordered_map<Position, Node> allNodes;
+    std::optional<Node> goal =
+        searchPath(*version, {&start, 1}, {&target, 1}, options, allNodes);
+    return goal ? unwindPath(*goal) : std::vector<Position>();
+}
+
+/**
+ * @brief Plan a single path like FindPath and return it run length encoded. The path is compressed
+ * straight from the search nodes, the cells are never stored one by one
+ *
+ * @param start,target Start and target position of the query
+ * @param options Per query settings, see FindPath
+ *
+ * @return CompressedPath from start to target, empty if no path exists or the search was stopped
+ *
+ */
+CompressedPath PathFinder::FindCompressedPath(const Position &start, const Position &target,
+                                              const QueryOptions &options) const
+{
+    TraceSpan span("FindCompressedPath");
+    const auto version = GetMapVersion();
+    if (!isPlannable(*version, start, target, options))
+    {
+        return {};
+    }
+    if (version->contractionHierarchy && options.useContractionHierarchy &&
+        options.unitSize <= 1 && !options.allowDiagonal && !options.isBlocked &&
+        options.movementClass == 0)
+    {
+        return CompressedPath(version->contractionHierarchy->FindPath(start, target));
+    }
+
+    std::unordered_map<Position, Node> allNodes;
+    std::optional<Node> goal =
+        searchPath(*version, {&start, 1}, {&target, 1}, options, allNodes);
+    return goal ? CompressedPath::FromParentChain(&*goal) : CompressedPath();
+}
+
+/**
+ * @brief Cheap checks rejecting queries that cannot have a path. Different components are rejected
+ * without exploring the start's whole component
+ *
+ * @param version Map version to check against
+ * @param start,target Start and target position of the query
+ * @param options Per query settings, the unit size and movement class are checked. Throws
+ * std::invalid_argument for unknown movement class ids
+ *
+ * @return true if a search is needed to decide whether a path exists
+ *
+ */
+bool PathFinder::isPlannable(const MapVersion &version, const Position &start,
+                             const Position &target, const QueryOptions &options) const
+{
+    if (options.movementClass < 0 ||
+        options.movementClass > static_cast<int>(version.movementClasses.size()))
+    {
+        throw std::invalid_argument("Unknown movement class id");
+    }
+    if (options.movementClass != 0)
+    {
+        const auto &components = version.movementClasses[options.movementClass - 1].components;
+        return isPassable(version, start, options) && isPassable(version, target, options) &&
+               (!components || components->RootAt(start) == components->RootAt(target));
+    }
+    return areConnected(version, start, target) && fitsUnit(version, start, options.unitSize) &&
+           fitsUnit(version, target, options.unitSize);
+}
+
+/**
+ * @brief Plan a single path to whichever of several targets is cheapest to reach, e.g. the nearest
+ * depot, with one search instead of one per target. Up to MaxHeuristicTargets targets are searched
+ * towards with the minimum distance to any of them as heuristic, larger sets are searched from all
+ * targets at once back to the start
+ *
+ * @param start Start position of the query
+ * @param targets Candidate targets, unreachable ones are ignored
+ * @param options Per query settings, see FindPath. The contraction hierarchy is not used
+ *
+ * @return vector<Position> path from start to the nearest target, empty if no target can be
+ * reached or the search was stopped
+ *
+ */
+std::vector<Position> PathFinder::FindPathToNearest(const Position &start,
+                                                    const std::vector<Position> &targets,
+                                                    const QueryOptions &options) const
+{
+    TraceSpan span("FindPathToNearest");
+    const auto version = GetMapVersion();
+    std::vector<Position> reachableTargets;
+    for (const auto &target : targets)
+    {
+        if (isPlannable(*version, start, target, options))
+        {
+            reachableTargets.push_back(target);
+        }
+    }
+    if (reachableTargets.empty())
+    {
+        return {};
+    }
+
+    std::unordered_map<Position, Node> allNodes;
+    if (reachableTargets.size() <= MaxHeuristicTargets)
+    {
+        std::optional<Node> goal =
+            searchPath(*version, {&start, 1}, reachableTargets, options, allNodes);
+        return goal ? unwindPath(*goal) : std::vector<Position>();
+    }
+
+    // Moves are symmetric, so the reversed path from the nearest target is a path to it
+    std::optional<Node> goal = searchPath(*version, reachableTargets, {&start, 1}, options, allNodes);
+    if (!goal)
+    {
+        return {};
+    }
+    std::vector<Position> path = unwindPath(*goal);
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+/**
+ * @brief Plan a single path that may end early on a cell whose remaining cost to the target is
+ * already known, e.g. a cell of an earlier shortest path to the same target, so the caller can
+ * continue along the known route. The search stops at the known cell or the target that gives the
+ * cheapest total cost, known cells are never expanded
+ *
+ * @param start,target Start and target position of the query
+ * @param knownCost Exact cost to the target of known cells in the units of the search, straight
+ * moves cost 1, or OctileStraightCost and OctileDiagonalCost with allowDiagonal. Returns -1 for
+ * other cells. Must be consistent with the options
+ * @param options Per query settings, see FindPath. The contraction hierarchy is not used
+ *
+ * @return vector<Position> path from start to the target or a known cell, empty if no path exists
+ * or the search was stopped
+ *
+ */
+std::vector<Position> PathFinder::FindPathToKnownCells(const Position &start,
+                                                       const Position &target,
+                                                       const KnownCost &knownCost,
+                                                       const QueryOptions &options) const
+{
+    TraceSpan span("FindPathToKnownCells");
+    const auto version = GetMapVersion();
+    if (!isPlannable(*version, start, target, options))
+    {
+        return {};
+    }
+
+    std::unordered_map<Position, Node> allNodes;
+    std::optional<Node> goal =
+        searchPath(*version, {&start, 1}, {&target, 1}, options, allNodes, knownCost);
+    return goal ? unwindPath(*goal) : std::vector<Position>();
+}
+
+/**
+ * @brief A* search shared by the single path queries, the query must have passed isPlannable
+ *
+ * @param version Map version to search
+ * @param starts Positions the search starts from at no cost
+ * @param targets The search ends at the first of them it reaches, the heuristic is the minimum
+ * distance to any of them
+ * @param options Per query settings, see FindPath
+ * @param allNodes Receives the search nodes, the parent chain of the result points into it
+ * @param knownCost Optional exact remaining cost of cells, these end the search like targets once
+ * their total cost is the cheapest in the open list
+ *
+ * @return Node of the target with its parent chain, std::nullopt if no path exists or the search
+ * was stopped
+ *
+ */
+std::optional<PathFinder::Node>
+PathFinder::searchPath(const MapVersion &version, std::span<const Position> starts,
+                       std::span<const Position> targets, const QueryOptions &options,
+                       std::unordered_map<Position, Node> &allNodes,
+                       const KnownCost &knownCost) const
+{
+    constexpr int StopCheckInterval = 256;
+    // Straight moves first, diagonal moves are only tried by octile searches
+    constexpr int Offsets[8][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1},
+                                   {1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+    const int moveCount = options.allowDiagonal ? 8 : 4;
+    const int straightCost = options.allowDiagonal ? OctileStraightCost : 1;
+    auto heuristic = [&](const Position &pos) {
+        int distance = std::numeric_limits<int>::max();
+        for (const auto &target : targets)
+        {
+            distance = std::min(distance, options.allowDiagonal ? octileDistance(pos, target)
+                                                                : manhattanDistance(pos, target));
+        }
+        return distance;
+    };
+
+    std::priority_queue<Node, std::vector<Node>, std::greater<Node>> openList;
+    std::unordered_set<Position> closedList;
+
+    for (const auto &start : starts)
+    {
+        Node startNode(start, 0, heuristic(start), nullptr);
+        allNodes[start] = startNode;
+        openList.push(startNode);
+    }
+
+    int expansions = 0;
+    while (!openList.empty())
+    {
+        if (options.shouldStop && ++expansions % StopCheckInterval == 0 && options.shouldStop())
+        {
+            return std::nullopt;
+        }
+
+        Node currentNode = openList.top();
+        openList.pop();
+        if (closedList.count(currentNode.pos))
+        {
+            continue;
+        }
+
+        if (std::find(targets.begin(), targets.end(), currentNode.pos) != targets.end())
+        {
+            return currentNode;
+        }
+        if (knownCost)
+        {
+            // A known cell is queued again with its exact cost, the search ends once it is the
+            // cheapest. Going past it cannot lead to a cheaper path
+            const int cost = knownCost(currentNode.pos);
+            if (cost >= 0)
+            {
+                if (currentNode.hCost == cost)
+                {
+                    return currentNode;
+                }
+                currentNode.hCost = cost;
+                openList.push(currentNode);
+                continue;
+            }
+        }
+
+        // Mark as visited
+        closedList.insert(currentNode.pos);
+
+        for (int move = 0; move < moveCount; ++move)
+        {
+            const int dx = Offsets[move][0];
+            const int dy = Offsets[move][1];
+            const Position neighbor(currentNode.pos.x + dx, currentNode.pos.y + dy);
+            if (!isPassable(version, neighbor, options) || closedList.count(neighbor) ||
+                (options.isBlocked && options.isBlocked(neighbor)))
+            {
+                continue;
+            }
+            const bool diagonal = dx != 0 && dy != 0;
+            // Diagonal moves may not cut corners, both cells beside the move must be free
+            if (diagonal &&
+                (!isPassable(version, {currentNode.pos.x + dx, currentNode.pos.y}, options) ||
+                 !isPassable(version, {currentNode.pos.x, currentNode.pos.y + dy}, options)))
+            {
+                continue;
+            }
+
+            int gCost = currentNode.gCost + (diagonal ? OctileDiagonalCost : straightCost);
+            auto existing = allNodes.find(neighbor);
+            if (existing == allNodes.end() || gCost < existing->second.gCost)
+            {
+                Node neighborNode(neighbor, gCost, heuristic(neighbor), &allNodes[currentNode.pos]);
+                allNodes[neighbor] = neighborNode;
+                openList.push(neighborNode);
+            }
+        }
+    }
+    return std::nullopt;
 }
 
 /**
- * @brief Used to print all the solved paths for the map
+ * @brief Used to print all the solved paths for the map. Compressed paths are printed as their
+ * waypoints
  *
  */
-void PathFinder::printPaths(const std::vector<std::vector<Position>> &paths) const
+void PathFinder::printPaths() const
 {
-    for (size_t i = 0; i < paths.size(); ++i)
+    const size_t unitCount = m_compressPaths ? m_compressedPaths.size() : m_solvedPaths.size();
+    for (size_t i = 0; i < unitCount; ++i)
     {
-        if (!paths[i].empty())
+        std::vector<Position> waypoints;
+        if (m_compressPaths)
         {
-            std::cout << "Path for unit " << i << ":" << std::endl;
-            for (const auto &pos : paths[i])
+            waypoints = m_compressedPaths[i].Waypoints();
+        }
+        const std::vector<Position> &path = m_compressPaths ? waypoints : m_solvedPaths[i];
+        if (!path.empty())
+        {
+            std::cout << (m_compressPaths ? "Waypoints for unit " : "Path for unit ") << i << ":"
+                      << std::endl;
+            for (const auto &pos : path)
             {
                 std::cout << "(" << pos.x << ", " << pos.y << ") ";
             }
@@ -490,7 +1930,7 @@ void PathFinder::printPaths(const std::vector<std::vector<Position>> &paths) con
  * @return vector<Position> all the viable positions the unit can move to from the current node
  *
  */
-std::vector<Position> PathFinder::getNeighborsforCurrentNode(Node currentNode)
+std::vector<Position> PathFinder::getNeighborsforCurrentNode(Node currentNode) const
 {
     return {{currentNode.pos.x + 1, currentNode.pos.y},
             {currentNode.pos.x - 1, currentNode.pos.y},
@@ -503,75 +1943,45 @@ std::vector<Position> PathFinder::getNeighborsforCurrentNode(Node currentNode)
  * positions with unique symbols. Function also prints all the solved paths for each unit. Each
  * unit's path has a unique color
  *
- * @param paths Solved paths for all the units in the map. Arguement has a default empty value to
- * reuse the function when printing the map after parsing but prior to solving
+ * @param version Map version to print. The paths solved by the last FindPaths call are drawn, none
+ * when printing the map after parsing but prior to solving
  *
  */
-void PathFinder::printMap(const std::vector<std::vector<Position>> &paths) const
+void PathFinder::printMap(const MapVersion &version) const
 {
-    int rows = m_map.size();
-    int cols = m_map[0].size();
-
-    for (int x = 0; x < rows; ++x)
+    MapRenderer renderer(version.map, {m_terrainKeys.at(Elevated), m_terrainKeys.at(Reachable)});
+    renderer.SetMarkers(version.startPositions, version.targetPositions);
+    if (m_compressPaths)
     {
-        for (int y = 0; y < cols; ++y)
-        {
-            Position current{x, y};
-            bool isPath = false;
-            bool isStart = false;
-            bool isTarget = false;
-            int colorCode;
-
-            // Check if the current position is a start or target position for any unit
-            for (size_t i = 0; i < m_startPositions.size(); ++i)
-            {
-                if (current == m_startPositions[i])
-                {
-                    isStart = true;
-                    break;
-                }
-                if (current == m_targetPositions[i])
-                {
-                    isTarget = true;
-                    break;
-                }
-            }
-
-            int iterator = 0;
-            // Check if the current position is part of any unit's path
-            for (const auto &path : paths)
-            {
-                if (std::find(path.begin(), path.end(), current) != path.end())
-                {
-                    isPath = true;
-                    colorCode = 31 + (iterator %
-                                      6); // Cycle through red, green, yellow, blue, magenta, cyan
-                }
-                iterator++;
-            }
+        renderer.SetPaths(m_compressedPaths);
+    }
+    else
+    {
+        renderer.SetPaths(m_solvedPaths);
+    }
+    renderer.WriteAnsi(std::cout);
+}
 
-            // Print the appropriate symbol
-            if (isStart)
-            {
-                std::cout << "S "; // Start
-            }
-            else if (isTarget)
-            {
-                std::cout << "T "; // Target
-            }
-            else if (isPath)
-            {
-                std::cout << "\033[" << colorCode << "m" << "P " << "\033[0m"; // Path
-            }
-            else if (m_map[x][y] == m_terrainKeys.at(Elevated))
-            {
-                std::cout << "# "; // Obstacle
-            }
-            else if (m_map[x][y] == m_terrainKeys.at(Reachable))
-            {
-                std::cout << ". "; // Free space
-            }
-        }
-        std::cout << '\n';
+/**
+ * @brief Export the map with all units and the paths solved by the last FindPaths call as a PPM
+ * image
+ *
+ * @param imageFilePath Destination path of the image
+ * @param cellPixels Edge length in pixels of each map cell
+ *
+ */
+void PathFinder::ExportImage(const std::string &imageFilePath, int cellPixels) const
+{
+    const auto version = GetMapVersion();
+    MapRenderer renderer(version->map, {m_terrainKeys.at(Elevated), m_terrainKeys.at(Reachable)});
+    renderer.SetMarkers(version->startPositions, version->targetPositions);
+    if (m_compressPaths)
+    {
+        renderer.SetPaths(m_compressedPaths);
+    }
+    else
+    {
+        renderer.SetPaths(m_solvedPaths);
     }
+    renderer.WritePPM(imageFilePath, cellPixels);
 }
\ No newline at end of file
@@ -1,14 +1,26 @@
 #ifndef PATHFINDER_HPP
 #define PATHFINDER_HPP
 
+// Local lib includes
+#include "ChunkedGrid.hpp"
+
 // Standard Includes
+#include <atomic>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 namespace PathPlanner
 {
+class CompressedPath;
+class ContractionHierarchy;
+
 class PathFinder
 {
   public:
@@ -45,6 +57,96 @@ class PathFinder
 
         bool operator>(const Node &other) const { return fCost() > other.fCost(); }
     };
+
+    // Per query settings for single unit searches
+    struct QueryOptions
+    {
+        // Polled while searching, the search is abandoned once it returns true
+        std::function<bool()> shouldStop;
+        // Edge length of the square footprint of the unit. Positions are the top left cell of the
+        // footprint, which must fit entirely on traversable cells
+        int unitSize;
+        // Also move diagonally at a cost of sqrt(2), as in the Moving AI benchmarks. Diagonal moves
+        // may not cut the corner of a blocked cell
+        bool allowDiagonal;
+        // Optional dynamic obstacles on top of the terrain, e.g. cells occupied by other units
+        std::function<bool(const Position &)> isBlocked;
+        // Passability rules of the unit, 0 for the terrain keys or an id from GetMovementClass
+        int movementClass;
+        // Answer eligible queries from the contraction hierarchy when one was built
+        bool useContractionHierarchy;
+
+        // Default constructor
+        QueryOptions()
+            : unitSize(1), allowDiagonal(false), movementClass(0), useContractionHierarchy(true)
+        {
+        }
+    };
+
+    // Exact cost from a cell to the target of a query, e.g. for cells on earlier shortest paths to
+    // it, or -1 if unknown
+    using KnownCost = std::function<int(const Position &)>;
+
+    // Clearance values are capped, larger units cannot be planned for
+    static constexpr int MaxClearance = 255;
+    // Nearest target queries with more targets search from the targets back to the start, since
+    // the heuristic takes the minimum over all targets
+    static constexpr size_t MaxHeuristicTargets = 8;
+    // Fixed point move costs of diagonal searches, straight moves of other searches cost 1
+    static constexpr int OctileStraightCost = 10000;
+    static constexpr int OctileDiagonalCost = 14142;
+
+    // Connected components of the traversable cells, chunked like the map so an edit copies only
+    // the chunks it touches. Opening a cell merges the components around it through the root table
+    // instead of relabeling cells, and blocking a cell never splits a component. Cells with
+    // different roots are therefore never connected, while cells sharing a root may have been
+    // separated by later edits
+    struct ComponentLabels
+    {
+        // Component of every cell, -1 for blocked cells
+        ChunkedGrid labels;
+        // Root component of every label
+        std::vector<int> roots;
+
+        int RootAt(const Position &pos) const { return roots[labels.At(pos.x, pos.y)]; }
+    };
+
+    // Passability of a configured movement class. Values of the first map layer are checked
+    // against the map, so terrain edits apply, the other layers are folded into a bitmap at load
+    struct MovementClass
+    {
+        std::vector<int> blockedTerrain;
+        // One bit per cell in row major order, set for cells another layer blocks
+        std::shared_ptr<const std::vector<uint64_t>> blockedCells;
+        // Connected components of the cells passable for the class, built after the bitmap
+        std::shared_ptr<const ComponentLabels> components;
+    };
+
+    // Immutable version of the parsed map and every structure derived from it. Versions are shared
+    // between PathFinder instances loading the same inputs, and SetTerrain publishes a new version
+    // instead of modifying the current one, so a search keeps the version it started with
+    struct MapVersion
+    {
+        ChunkedGrid map;
+        std::vector<Position> startPositions;
+        std::vector<Position> targetPositions;
+        // Computed while loading JSON and Moving AI maps and updated by edits. Chunk file maps have
+        // none so that queries never decode the whole map, their queries skip the connectivity
+        // check
+        std::shared_ptr<const ComponentLabels> componentLabels;
+        // Edge length of the largest traversable square with its top left corner at each cell.
+        // Computed like the component labels, without it unit footprints are checked cell by cell
+        std::shared_ptr<const ChunkedGrid> clearance;
+        // Optional preprocessed hierarchy answering single cell unit queries, only valid for the
+        // terrain it was built from
+        std::shared_ptr<const ContractionHierarchy> contractionHierarchy;
+        // Configured movement classes, indexed by movement class id minus one. The clearance and
+        // contraction hierarchy only describe the terrain keys
+        std::vector<MovementClass> movementClasses;
+        // Number of edits since the map was loaded
+        uint64_t revision = 0;
+    };
+
     // Constructor
     PathFinder(const std::string &configFilePath);
 
@@ -53,30 +155,108 @@ class PathFinder
 
     // Public methods
     void FindPaths();
-    const std::vector<std::vector<int>> &GetMap() const { return m_map; }
+    std::vector<Position> FindPath(const Position &start, const Position &target,
+                                   const QueryOptions &options = {}) const;
+    CompressedPath FindCompressedPath(const Position &start, const Position &target,
+                                      const QueryOptions &options = {}) const;
+    std::vector<Position> FindPathToNearest(const Position &start,
+                                            const std::vector<Position> &targets,
+                                            const QueryOptions &options = {}) const;
+    std::vector<Position> FindPathToKnownCells(const Position &start, const Position &target,
+                                               const KnownCost &knownCost,
+                                               const QueryOptions &options = {}) const;
+    std::shared_ptr<const MapVersion> GetMapVersion() const;
+    ChunkedGrid GetMap() const { return GetMapVersion()->map; }
     Position GetStartPosition(int index) const;
     Position GetTargetPosition(int index) const;
+    size_t GetUnitCount() const { return GetMapVersion()->startPositions.size(); }
+    bool IsTraversable(const Position &pos) const;
+    bool IsTraversable(const MapVersion &version, const Position &pos) const
+    {
+        return isValidPosition(version.map, pos);
+    }
+    bool AreConnected(const Position &a, const Position &b) const;
+    bool AreConnected(const MapVersion &version, const Position &a, const Position &b) const
+    {
+        return areConnected(version, a, b);
+    }
+    int GetClearance(const Position &pos) const;
+    int GetMovementClass(const std::string &name) const;
+    void SetTerrain(const Position &pos, int value);
+    bool IsLoadedFromSnapshot() const { return m_loadedFromSnapshot; }
+    bool IsSharingMap() const { return m_sharingMap; }
+    bool HasContractionHierarchy() const { return GetMapVersion()->contractionHierarchy != nullptr; }
+    void ExportChunkFile(const std::string &chunkFilePath) const;
+    void ExportImage(const std::string &imageFilePath, int cellPixels = 1) const;
+    const std::vector<std::vector<Position>> &GetPaths() const { return m_solvedPaths; }
+    const std::vector<CompressedPath> &GetCompressedPaths() const { return m_compressedPaths; }
 
   private:
     // Private members
-    std::vector<std::vector<int>> m_map;
-    std::vector<Position> m_startPositions;
-    std::vector<Position> m_targetPositions;
+    // Current map version, SetTerrain swaps in a new one. Readers never take m_editMutex. The
+    // atomic is not lock free in libstdc++: a load holds an internal spin lock for the pointer
+    // copy only, it never waits for an edit to build its version
+    std::atomic<std::shared_ptr<const MapVersion>> m_version;
+    // Serializes SetTerrain calls, readers never take it
+    std::mutex m_editMutex;
     std::unordered_map<std::string, int> m_terrainKeys;
     std::string m_mapFilePath;
+    int m_chunkSize = ChunkedGrid::DefaultChunkSize;
+    size_t m_chunkMemoryLimit = 0;
+    std::string m_snapshotFilePath;
+    bool m_loadedFromSnapshot = false;
+    // Reuse the map version of other instances loaded from the same inputs
+    bool m_shareMap = true;
+    bool m_sharingMap = false;
+    // Skips all console rendering, for maps too large to print or non interactive runs
+    bool m_headless = false;
+    std::string m_imageFilePath;
+    std::vector<std::vector<Position>> m_solvedPaths;
+    // FindPaths stores run length encoded paths in m_compressedPaths instead of m_solvedPaths
+    bool m_compressPaths = false;
+    std::vector<CompressedPath> m_compressedPaths;
+    bool m_buildContractionHierarchy = false;
+    // Blocking values per layer name of each configured movement class, in id order
+    struct MovementClassRule
+    {
+        std::string name;
+        std::vector<std::pair<std::string, std::vector<int>>> blockedValues;
+    };
+    std::vector<MovementClassRule> m_movementClassRules;
 
     // Private methods
     void parseConfig(const std::string &m_configFile);
-    void parseMap(const std::string &mapFile);
-    bool isValidPosition(const Position &pos) const;
+    void parseMap(const std::string &mapFile, MapVersion &version);
+    void parseChunkFile(const std::string &chunkFile, MapVersion &version);
+    void parseMovingAIMap(const std::string &mapFile, MapVersion &version);
+    uint64_t computeSourceTag() const;
+    bool loadSnapshot(uint64_t sourceTag, MapVersion &version);
+    void saveSnapshot(uint64_t sourceTag, const MapVersion &version) const;
+    ComponentLabels labelComponents(const MapVersion &version, int movementClass) const;
+    void updateComponents(const MapVersion &version, int movementClass,
+                          ComponentLabels &components, const Position &pos) const;
+    ChunkedGrid computeClearance(const ChunkedGrid &map) const;
+    void updateClearance(const ChunkedGrid &map, ChunkedGrid &clearance,
+                         const Position &pos) const;
+    bool areConnected(const MapVersion &version, const Position &a, const Position &b) const;
+    bool fitsUnit(const MapVersion &version, const Position &pos, int unitSize) const;
+    bool isPassable(const MapVersion &version, const Position &pos,
+                    const QueryOptions &options) const;
+    bool isValidPosition(const ChunkedGrid &map, const Position &pos) const;
     int manhattanDistance(Position a, Position b) const;
+    int octileDistance(Position a, Position b) const;
     bool hasCollision(const std::vector<Position> &positions, const Position &newPosition,
                       size_t currentIndex) const;
-    void printMap(const std::vector<std::vector<Position>> &paths = {}) const;
-    void validateMapPositions();
-    std::vector<Position> getNeighborsforCurrentNode(Node currentNode);
-    void printPaths(const std::vector<std::vector<Position>> &paths) const;
-
+    void printMap(const MapVersion &version) const;
+    void validateMapPositions(MapVersion &version);
+    bool isPlannable(const MapVersion &version, const Position &start, const Position &target,
+                     const QueryOptions &options) const;
+    std::optional<Node> searchPath(const MapVersion &version, std::span<const Position> starts,
+                                   std::span<const Position> targets, const QueryOptions &options,
+                                   std::unordered_map<Position, Node> &allNodes,
+                                   const KnownCost &knownCost = {}) const;
+    std::vector<Position> getNeighborsforCurrentNode(Node currentNode) const;
+    void printPaths() const;
 };
 } // namespace PathPlanner
 
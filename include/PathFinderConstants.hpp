@@ -17,6 +17,21 @@ namespace PathPlanner
     inline const std::string TileWidth = "tilewidth";
     inline const std::string Layers = "layers";
     inline const std::string Data = "data";
+    inline const std::string ChunkSize = "chunkSize";
+    inline const std::string ChunkMemoryLimit = "chunkMemoryLimit";
+    inline const std::string SnapshotFile = "snapshotFile";
+    inline const std::string Headless = "headless";
+    inline const std::string ImageFile = "imageFile";
+    inline const std::string CompressPaths = "compressPaths";
+    inline const std::string BuildContractionHierarchy = "contractionHierarchy";
+    inline const std::string ShareMap = "shareMap";
+    inline const std::string MovementClasses = "movementClasses";
+    inline const std::string LayerName = "name";
+
+    // Map files with this extension are read as lazily loaded chunk files
+    inline const std::string ChunkFileExtension = ".chunks";
+    // Map files with this extension are read as Moving AI benchmark grids
+    inline const std::string MovingAIMapExtension = ".map";
 
 }
 
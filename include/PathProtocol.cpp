@@ -0,0 +1,67 @@
+// Local lib includes
+#include "PathProtocol.hpp"
+
+// System Includes
+#include <cerrno>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/**
+ * @brief Read exactly size bytes from a socket
+ *
+ * @param socketFd Connected socket
+ * @param buffer Destination buffer of at least size bytes
+ * @param size Number of bytes to read
+ *
+ * @return bool false if the peer closed the connection or the read failed
+ *
+ */
+bool PathPlanner::Protocol::ReadExact(int socketFd, void *buffer, size_t size)
+{
+    char *cursor = static_cast<char *>(buffer);
+    while (size > 0)
+    {
+        ssize_t received = ::read(socketFd, cursor, size);
+        if (received < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (received <= 0)
+        {
+            return false;
+        }
+        cursor += received;
+        size -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+/**
+ * @brief Write exactly size bytes to a socket
+ *
+ * @param socketFd Connected socket
+ * @param buffer Source buffer of at least size bytes
+ * @param size Number of bytes to write
+ *
+ * @return bool false if the write failed
+ *
+ */
+bool PathPlanner::Protocol::WriteExact(int socketFd, const void *buffer, size_t size)
+{
+    const char *cursor = static_cast<const char *>(buffer);
+    while (size > 0)
+    {
+        ssize_t sent = ::send(socketFd, cursor, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (sent <= 0)
+        {
+            return false;
+        }
+        cursor += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
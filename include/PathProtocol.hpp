@@ -0,0 +1,78 @@
+#ifndef PATH_PROTOCOL_HPP
+#define PATH_PROTOCOL_HPP
+
+// Standard Includes
+#include <cstddef>
+#include <cstdint>
+
+// Binary request/response protocol spoken by the path server over a Unix domain socket. All fields
+// are in host byte order since both ends run on the same machine.
+//
+// Request:  RequestHeader, then for Query requests `count` entries of int32 {sx, sy, tx, ty}
+// Response: ResponseHeader, then for Query requests `count` entries of uint32 length followed by
+//           `length` pairs of int32 {x, y}; for MapInfo requests a single MapInfo record
+namespace PathPlanner::Protocol
+{
+inline constexpr uint32_t Magic = 0x50535452; // "RTSP"
+inline constexpr uint16_t Version = 1;
+// Upper bound on queries per batch, protects the server from absurd allocations
+inline constexpr uint32_t MaxBatchSize = 1u << 20;
+
+enum class RequestType : uint16_t
+{
+    Query = 1,
+    MapInfo = 2,
+};
+
+enum class Status : uint16_t
+{
+    Ok = 0,
+    BadRequest = 1,
+    UnknownMap = 2,
+    // A query of the batch failed on the server, e.g. a chunk file could not be read
+    InternalError = 3,
+    // The server is at its connection limit and closed the connection
+    Busy = 4,
+};
+
+#pragma pack(push, 1)
+struct RequestHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t type;
+    uint32_t mapId;
+    uint32_t count;
+};
+
+struct ResponseHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t status;
+    uint32_t count;
+};
+
+struct QueryRecord
+{
+    int32_t startX;
+    int32_t startY;
+    int32_t targetX;
+    int32_t targetY;
+};
+
+struct MapInfo
+{
+    int32_t rows;
+    int32_t cols;
+    uint32_t unitCount;
+};
+#pragma pack(pop)
+
+// Read or write exactly `size` bytes on a socket, retrying on partial transfers and interrupts.
+// Return false if the peer closed the connection or an error occurred
+bool ReadExact(int socketFd, void *buffer, size_t size);
+bool WriteExact(int socketFd, const void *buffer, size_t size);
+} // namespace PathPlanner::Protocol
+
+#endif // PATH_PROTOCOL_HPP
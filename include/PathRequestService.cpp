@@ -0,0 +1,195 @@
+// Local lib includes
+#include "PathRequestService.hpp"
+
+using namespace PathPlanner;
+
+/**
+ * @brief Constructor for the PathRequestService Class. Starts the worker pool
+ *
+ * @param pathFinder PathFinder answering the queries, must outlive the service
+ * @param options Worker count and queue limit
+ *
+ */
+PathRequestService::PathRequestService(const PathFinder &pathFinder, Options options)
+    : m_pathFinder(pathFinder), m_options(options), m_workers(options.threadCount)
+{
+}
+
+/**
+ * @brief Destructor for the PathRequestService Class. Cancels all pending requests so the workers
+ * finish promptly, the worker pool is joined afterwards
+ */
+PathRequestService::~PathRequestService()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto &[id, job] : m_pending)
+    {
+        job->cancelled = true;
+        finish(*job, Status::Cancelled);
+    }
+    m_pending.clear();
+}
+
+/**
+ * @brief Queue a path request
+ *
+ * @param request Start, target, priority and optional deadline of the query
+ *
+ * @return Handle with the request id used for cancellation and a future for the response
+ *
+ */
+PathRequestService::Handle PathRequestService::Submit(const Request &request)
+{
+    auto job = std::make_shared<Job>();
+    job->request = request;
+    Handle handle;
+    handle.result = job->promise.get_future().share();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        job->id = m_nextId++;
+        handle.id = job->id;
+        if (m_options.maxPending > 0 && m_pending.size() >= m_options.maxPending)
+        {
+            finish(*job, Status::Rejected);
+            return handle;
+        }
+        m_pending[job->id] = job;
+        m_queue.push(job);
+    }
+
+    // Each submission adds one drain step; the step serves whichever job is most urgent by then
+    m_workers.Submit([this]() { runNext(); });
+    return handle;
+}
+
+/**
+ * @brief Cancel a queued or running request. Its response is set to Cancelled right away and a
+ * running search is abandoned at its next stop check
+ *
+ * @param id Id returned by Submit
+ *
+ * @return bool true if the request was still pending and is now cancelled
+ *
+ */
+bool PathRequestService::Cancel(RequestId id)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto found = m_pending.find(id);
+    if (found == m_pending.end())
+    {
+        return false;
+    }
+    auto job = found->second;
+    m_pending.erase(found);
+    job->cancelled = true;
+    finish(*job, Status::Cancelled);
+    return true;
+}
+
+/**
+ * @brief Number of requests that are queued or being searched
+ *
+ */
+size_t PathRequestService::GetPendingCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pending.size();
+}
+
+/**
+ * @brief Worker step. Pops the most urgent job, skipping cancelled ones, and runs its search
+ */
+void PathRequestService::runNext()
+{
+    std::shared_ptr<Job> job;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // Cancelled jobs stay in the heap until popped, each of them still has its own drain step
+        if (m_queue.empty())
+        {
+            return;
+        }
+        job = m_queue.top();
+        m_queue.pop();
+    }
+    if (job->cancelled)
+    {
+        return;
+    }
+
+    const auto &deadline = job->request.deadline;
+    std::vector<Position> path;
+    CompressedPath compressedPath;
+    if (!deadline || Clock::now() < *deadline)
+    {
+        PathFinder::QueryOptions options;
+        options.shouldStop = [&job, &deadline]() {
+            return job->cancelled.load() || (deadline && Clock::now() >= *deadline);
+        };
+        if (job->request.compressed)
+        {
+            compressedPath =
+                m_pathFinder.FindCompressedPath(job->request.start, job->request.target, options);
+        }
+        else
+        {
+            path = m_pathFinder.FindPath(job->request.start, job->request.target, options);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.erase(job->id);
+    }
+    if (deadline && Clock::now() >= *deadline)
+    {
+        finish(*job, Status::Expired);
+    }
+    else if (path.empty() && compressedPath.Empty())
+    {
+        finish(*job, Status::NoPath);
+    }
+    else
+    {
+        finish(*job, Status::Completed, std::move(path), std::move(compressedPath));
+    }
+}
+
+/**
+ * @brief Fulfill the promise of a job exactly once. Later calls, e.g. a worker finishing a search
+ * after the job was cancelled, are ignored
+ *
+ */
+void PathRequestService::finish(Job &job, Status status, std::vector<Position> path,
+                                CompressedPath compressedPath)
+{
+    if (!job.finished.exchange(true))
+    {
+        job.promise.set_value({status, std::move(path), std::move(compressedPath)});
+    }
+}
+
+/**
+ * @brief Heap ordering, returns true if job a should be served after job b
+ *
+ */
+bool PathRequestService::JobOrder::operator()(const std::shared_ptr<Job> &a,
+                                              const std::shared_ptr<Job> &b) const
+{
+    if (a->request.priority != b->request.priority)
+    {
+        return a->request.priority < b->request.priority;
+    }
+    const auto &deadlineA = a->request.deadline;
+    const auto &deadlineB = b->request.deadline;
+    if (deadlineA != deadlineB)
+    {
+        // Requests with a deadline go before those without one
+        if (!deadlineA || !deadlineB)
+        {
+            return !deadlineA;
+        }
+        return *deadlineA > *deadlineB;
+    }
+    return a->id > b->id;
+}
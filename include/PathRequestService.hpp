@@ -0,0 +1,130 @@
+#ifndef PATH_REQUEST_SERVICE_HPP
+#define PATH_REQUEST_SERVICE_HPP
+
+// Local lib includes
+#include "CompressedPath.hpp"
+#include "PathFinder.hpp"
+#include "ThreadPool.hpp"
+
+// Standard Includes
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+namespace PathPlanner
+{
+// Asynchronous front end for single unit path queries on a PathFinder. Requests are queued by
+// priority and deadline and drained by a bounded worker pool. Cancelled and expired requests are
+// dropped before or during their search.
+class PathRequestService
+{
+  public:
+    using Position = PathFinder::Position;
+    using Clock = std::chrono::steady_clock;
+    using RequestId = uint64_t;
+
+    // Higher priorities are served first, e.g. player orders before AI scouting
+    enum class Priority
+    {
+        Low = 0,
+        Normal = 1,
+        High = 2,
+    };
+
+    enum class Status
+    {
+        Completed,
+        NoPath,
+        Cancelled,
+        Expired,
+        Rejected,
+    };
+
+    struct Request
+    {
+        Position start;
+        Position target;
+        Priority priority = Priority::Normal;
+        // Requests not finished by the deadline are reported as expired
+        std::optional<Clock::time_point> deadline;
+        // Answer with a run length encoded path in Response::compressedPath instead of cells
+        bool compressed = false;
+    };
+
+    struct Response
+    {
+        Status status;
+        std::vector<Position> path;
+        CompressedPath compressedPath;
+    };
+
+    struct Handle
+    {
+        RequestId id;
+        std::shared_future<Response> result;
+    };
+
+    struct Options
+    {
+        // Worker threads, 0 uses the number of hardware threads
+        size_t threadCount = 0;
+        // Requests beyond this many queued ones are rejected, 0 for no limit
+        size_t maxPending = 0;
+    };
+
+    // Constructor
+    PathRequestService(const PathFinder &pathFinder, Options options);
+    explicit PathRequestService(const PathFinder &pathFinder)
+        : PathRequestService(pathFinder, Options())
+    {
+    }
+
+    // Destructor, cancels every request that has not finished yet
+    ~PathRequestService();
+
+    // Public methods
+    Handle Submit(const Request &request);
+    bool Cancel(RequestId id);
+    size_t GetPendingCount() const;
+
+  private:
+    struct Job
+    {
+        RequestId id;
+        Request request;
+        std::promise<Response> promise;
+        std::atomic<bool> cancelled{false};
+        std::atomic<bool> finished{false};
+    };
+
+    // Orders jobs by priority, then earliest deadline, then submission order
+    struct JobOrder
+    {
+        bool operator()(const std::shared_ptr<Job> &a, const std::shared_ptr<Job> &b) const;
+    };
+
+    // Private members
+    const PathFinder &m_pathFinder;
+    Options m_options;
+    std::priority_queue<std::shared_ptr<Job>, std::vector<std::shared_ptr<Job>>, JobOrder> m_queue;
+    std::unordered_map<RequestId, std::shared_ptr<Job>> m_pending;
+    mutable std::mutex m_mutex;
+    RequestId m_nextId = 1;
+    // Declared last so the workers are joined before the queue is destroyed
+    ThreadPool m_workers;
+
+    // Private methods
+    void runNext();
+    static void finish(Job &job, Status status, std::vector<Position> path = {},
+                       CompressedPath compressedPath = {});
+};
+} // namespace PathPlanner
+
+#endif // PATH_REQUEST_SERVICE_HPP
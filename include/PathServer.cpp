@@ -0,0 +1,357 @@
+// Local lib includes
+#include "PathServer.hpp"
+#include "Tracer.hpp"
+
+// System Includes
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Standard Includes
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+using namespace PathPlanner;
+using Position = PathPlanner::PathFinder::Position;
+
+namespace
+{
+// How often the accept loop checks for a stop request
+constexpr int AcceptPollIntervalMs = 100;
+} // namespace
+
+/**
+ * @brief Constructor for the PathServer Class. Loads every map and binds the listening socket so
+ * clients can connect as soon as the constructor returns
+ *
+ * @param configFilePaths Config files of the maps to keep resident, map id i refers to entry i
+ * @param socketPath File system path of the Unix domain socket, replaced if it already exists
+ * @param threadCount Workers answering queries, 0 uses the number of hardware threads
+ * @param maxConnections Connections served at once, further clients are answered with
+ * Status::Busy and disconnected. Throws std::invalid_argument if 0
+ *
+ */
+PathServer::PathServer(const std::vector<std::string> &configFilePaths,
+                       const std::string &socketPath, size_t threadCount, size_t maxConnections)
+    : m_socketPath(socketPath), m_maxConnections(maxConnections), m_workers(threadCount)
+{
+    if (m_maxConnections == 0)
+    {
+        throw std::invalid_argument("Server needs to accept at least one connection");
+    }
+    for (const auto &configFilePath : configFilePaths)
+    {
+        m_pathFinders.push_back(std::make_unique<PathFinder>(configFilePath));
+    }
+    openSocket();
+}
+
+/**
+ * @brief Destructor for the PathServer Class. Closes all connections and removes the socket file
+ */
+PathServer::~PathServer()
+{
+    Stop();
+    std::vector<Connection> connections;
+    {
+        std::lock_guard<std::mutex> lock(m_connectionsMutex);
+        connections.swap(m_connections);
+    }
+    for (auto &connection : connections)
+    {
+        connection.thread.join();
+    }
+    if (m_listenFd >= 0)
+    {
+        ::close(m_listenFd);
+        ::unlink(m_socketPath.c_str());
+    }
+}
+
+/**
+ * @brief Accept connections until Stop is called. Each connection is served on its own thread,
+ * clients beyond the connection limit are turned away
+ */
+void PathServer::Run()
+{
+    m_running = true;
+    std::cout << "Serving " << m_pathFinders.size() << " map(s) on " << m_socketPath << std::endl;
+    while (!m_stopRequested)
+    {
+        pollfd listenPoll{m_listenFd, POLLIN, 0};
+        int ready = ::poll(&listenPoll, 1, AcceptPollIntervalMs);
+        if (ready <= 0 || m_stopRequested)
+        {
+            continue;
+        }
+        int clientFd = ::accept(m_listenFd, nullptr, nullptr);
+        if (clientFd < 0)
+        {
+            continue;
+        }
+        reapConnections();
+        std::lock_guard<std::mutex> lock(m_connectionsMutex);
+        if (m_connections.size() >= m_maxConnections)
+        {
+            sendStatus(clientFd, Protocol::Status::Busy);
+            ::close(clientFd);
+            continue;
+        }
+        auto finished = std::make_shared<std::atomic<bool>>(false);
+        m_connections.push_back(
+            {std::thread(&PathServer::serveConnection, this, clientFd, finished), finished});
+    }
+    m_running = false;
+}
+
+/**
+ * @brief Ask the accept loop to exit. Safe to call from another thread or a signal handler
+ */
+void PathServer::Stop()
+{
+    m_stopRequested = true;
+}
+
+/**
+ * @brief Join the threads of connections that have been closed
+ */
+void PathServer::reapConnections()
+{
+    std::lock_guard<std::mutex> lock(m_connectionsMutex);
+    auto closed = std::partition(m_connections.begin(), m_connections.end(),
+                                 [](const Connection &connection) { return !*connection.finished; });
+    for (auto it = closed; it != m_connections.end(); ++it)
+    {
+        it->thread.join();
+    }
+    m_connections.erase(closed, m_connections.end());
+}
+
+/**
+ * @brief Create, bind and listen on the Unix domain socket
+ */
+void PathServer::openSocket()
+{
+    sockaddr_un address{};
+    if (m_socketPath.size() >= sizeof(address.sun_path))
+    {
+        throw std::runtime_error("Socket path too long: " + m_socketPath);
+    }
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, m_socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    m_listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_listenFd < 0)
+    {
+        throw std::runtime_error("Failed to create socket: " + std::string(std::strerror(errno)));
+    }
+    ::unlink(m_socketPath.c_str());
+    if (::bind(m_listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 ||
+        ::listen(m_listenFd, SOMAXCONN) < 0)
+    {
+        std::string error = std::strerror(errno);
+        ::close(m_listenFd);
+        m_listenFd = -1;
+        throw std::runtime_error("Failed to listen on " + m_socketPath + ": " + error);
+    }
+}
+
+/**
+ * @brief Serve requests on one connection until the client disconnects, sends a malformed request
+ * or the server stops. Errors close the connection instead of escaping the thread
+ *
+ * @param clientFd Accepted client socket, closed before returning
+ * @param finished Set once the connection is closed so its thread can be joined
+ *
+ */
+void PathServer::serveConnection(int clientFd, std::shared_ptr<std::atomic<bool>> finished)
+{
+    try
+    {
+        serveRequests(clientFd);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Closing connection after error: " << e.what() << std::endl;
+    }
+    ::close(clientFd);
+    *finished = true;
+}
+
+/**
+ * @brief Read and answer requests from one client until the connection should be closed
+ *
+ * @param clientFd Accepted client socket
+ *
+ */
+void PathServer::serveRequests(int clientFd)
+{
+    while (!m_stopRequested)
+    {
+        // Wake up periodically so idle connections notice a stop request
+        pollfd clientPoll{clientFd, POLLIN, 0};
+        int ready = ::poll(&clientPoll, 1, AcceptPollIntervalMs);
+        if (ready == 0)
+        {
+            continue;
+        }
+        Protocol::RequestHeader header;
+        if (ready < 0 || !Protocol::ReadExact(clientFd, &header, sizeof(header)))
+        {
+            break;
+        }
+        if (header.magic != Protocol::Magic || header.version != Protocol::Version)
+        {
+            sendStatus(clientFd, Protocol::Status::BadRequest);
+            break;
+        }
+
+        bool keepOpen = false;
+        switch (static_cast<Protocol::RequestType>(header.type))
+        {
+        case Protocol::RequestType::Query:
+            keepOpen = handleQuery(clientFd, header);
+            break;
+        case Protocol::RequestType::MapInfo:
+            keepOpen = handleMapInfo(clientFd, header);
+            break;
+        default:
+            sendStatus(clientFd, Protocol::Status::BadRequest);
+            break;
+        }
+        if (!keepOpen)
+        {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Answer a batch of path queries. The batch is split into slices that are planned in
+ * parallel, and the whole response is sent with a single write. If a query throws, every slice is
+ * still waited for and the batch is answered with Status::InternalError
+ *
+ * @return bool true if the connection can be used for further requests
+ *
+ */
+bool PathServer::handleQuery(int clientFd, const Protocol::RequestHeader &header)
+{
+    TraceSpan span("handleQuery", "PathServer", "queries", header.count);
+    if (header.count > Protocol::MaxBatchSize)
+    {
+        sendStatus(clientFd, Protocol::Status::BadRequest);
+        return false;
+    }
+    std::vector<Protocol::QueryRecord> queries(header.count);
+    if (!Protocol::ReadExact(clientFd, queries.data(),
+                             queries.size() * sizeof(Protocol::QueryRecord)))
+    {
+        return false;
+    }
+    if (header.mapId >= m_pathFinders.size())
+    {
+        return sendStatus(clientFd, Protocol::Status::UnknownMap);
+    }
+
+    const PathFinder &pathFinder = *m_pathFinders[header.mapId];
+    std::vector<std::vector<Position>> paths(queries.size());
+    const size_t sliceSize = std::max<size_t>(1, queries.size() / (m_workers.Size() * 4));
+    std::atomic<bool> failed = false;
+    std::vector<std::future<void>> slices;
+    for (size_t begin = 0; begin < queries.size(); begin += sliceSize)
+    {
+        const size_t end = std::min(queries.size(), begin + sliceSize);
+        slices.push_back(m_workers.Submit([&, begin, end]() {
+            // Slices write into this frame, so errors must not end the wait for the others
+            try
+            {
+                for (size_t i = begin; i < end && !failed; ++i)
+                {
+                    paths[i] = pathFinder.FindPath({queries[i].startX, queries[i].startY},
+                                                   {queries[i].targetX, queries[i].targetY});
+                }
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << "Query failed: " << e.what() << std::endl;
+                failed = true;
+            }
+        }));
+    }
+    for (auto &slice : slices)
+    {
+        slice.wait();
+    }
+    if (failed)
+    {
+        return sendStatus(clientFd, Protocol::Status::InternalError);
+    }
+
+    size_t pathCells = 0;
+    for (const auto &path : paths)
+    {
+        pathCells += path.size();
+    }
+    std::vector<char> response(sizeof(Protocol::ResponseHeader) + paths.size() * sizeof(uint32_t) +
+                               pathCells * 2 * sizeof(int32_t));
+    char *cursor = response.data();
+    Protocol::ResponseHeader responseHeader{Protocol::Magic, Protocol::Version,
+                                            static_cast<uint16_t>(Protocol::Status::Ok),
+                                            static_cast<uint32_t>(paths.size())};
+    std::memcpy(cursor, &responseHeader, sizeof(responseHeader));
+    cursor += sizeof(responseHeader);
+    for (const auto &path : paths)
+    {
+        uint32_t length = static_cast<uint32_t>(path.size());
+        std::memcpy(cursor, &length, sizeof(length));
+        cursor += sizeof(length);
+        for (const auto &pos : path)
+        {
+            int32_t cell[2] = {pos.x, pos.y};
+            std::memcpy(cursor, cell, sizeof(cell));
+            cursor += sizeof(cell);
+        }
+    }
+    return Protocol::WriteExact(clientFd, response.data(), response.size());
+}
+
+/**
+ * @brief Report the dimensions and unit count of a resident map
+ *
+ * @return bool true if the connection can be used for further requests
+ *
+ */
+bool PathServer::handleMapInfo(int clientFd, const Protocol::RequestHeader &header)
+{
+    if (header.mapId >= m_pathFinders.size())
+    {
+        return sendStatus(clientFd, Protocol::Status::UnknownMap);
+    }
+    const PathFinder &pathFinder = *m_pathFinders[header.mapId];
+
+    struct
+    {
+        Protocol::ResponseHeader header;
+        Protocol::MapInfo info;
+    } response{{Protocol::Magic, Protocol::Version, static_cast<uint16_t>(Protocol::Status::Ok), 1},
+               {pathFinder.GetMap().Rows(), pathFinder.GetMap().Cols(),
+                static_cast<uint32_t>(pathFinder.GetUnitCount())}};
+    return Protocol::WriteExact(clientFd, &response, sizeof(response));
+}
+
+/**
+ * @brief Send a response header without payload
+ *
+ * @return bool true if the header was written
+ *
+ */
+bool PathServer::sendStatus(int clientFd, Protocol::Status status)
+{
+    Protocol::ResponseHeader header{Protocol::Magic, Protocol::Version,
+                                    static_cast<uint16_t>(status), 0};
+    return Protocol::WriteExact(clientFd, &header, sizeof(header));
+}
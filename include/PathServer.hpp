@@ -0,0 +1,73 @@
+#ifndef PATH_SERVER_HPP
+#define PATH_SERVER_HPP
+
+// Local lib includes
+#include "PathFinder.hpp"
+#include "PathProtocol.hpp"
+#include "ThreadPool.hpp"
+
+// Standard Includes
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace PathPlanner
+{
+// Long running server keeping one PathFinder per config resident and answering batched path
+// queries over a Unix domain socket. Map ids are the index of the config in the list passed at
+// construction. Each connection is served by its own thread, up to a connection limit, and queries
+// of a batch are spread over a shared worker pool.
+class PathServer
+{
+  public:
+    static constexpr size_t DefaultMaxConnections = 256;
+
+    // Constructor, loads every map up front
+    PathServer(const std::vector<std::string> &configFilePaths, const std::string &socketPath,
+               size_t threadCount = 0, size_t maxConnections = DefaultMaxConnections);
+
+    // Destructor, stops the server and removes the socket file
+    ~PathServer();
+
+    PathServer(const PathServer &) = delete;
+    PathServer &operator=(const PathServer &) = delete;
+
+    // Public methods
+    void Run();
+    void Stop();
+    bool IsRunning() const { return m_running; }
+    size_t GetMapCount() const { return m_pathFinders.size(); }
+
+  private:
+    struct Connection
+    {
+        std::thread thread;
+        std::shared_ptr<std::atomic<bool>> finished;
+    };
+
+    // Private members
+    std::vector<std::unique_ptr<PathFinder>> m_pathFinders;
+    std::string m_socketPath;
+    size_t m_maxConnections;
+    int m_listenFd = -1;
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_stopRequested{false};
+    std::mutex m_connectionsMutex;
+    std::vector<Connection> m_connections;
+    ThreadPool m_workers;
+
+    // Private methods
+    void openSocket();
+    void serveConnection(int clientFd, std::shared_ptr<std::atomic<bool>> finished);
+    void serveRequests(int clientFd);
+    void reapConnections();
+    bool handleQuery(int clientFd, const Protocol::RequestHeader &header);
+    bool handleMapInfo(int clientFd, const Protocol::RequestHeader &header);
+    bool sendStatus(int clientFd, Protocol::Status status);
+};
+} // namespace PathPlanner
+
+#endif // PATH_SERVER_HPP
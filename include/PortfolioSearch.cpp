@@ -0,0 +1,146 @@
+// Local lib includes
+#include "PortfolioSearch.hpp"
+#include "ContractionHierarchy.hpp"
+#include "FrontierSearch.hpp"
+#include "Tracer.hpp"
+
+// Standard Includes
+#include <algorithm>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+using namespace PathPlanner;
+using Position = PathPlanner::PathFinder::Position;
+
+/**
+ * @brief Constructor for the PortfolioSearch Class
+ *
+ * @param pathFinder PathFinder providing the map, must outlive the portfolio
+ * @param options Engines to race. Throws std::invalid_argument if none or a duplicate is given, or
+ * if the contraction hierarchy engine is requested for a map without one
+ *
+ */
+PortfolioSearch::PortfolioSearch(const PathFinder &pathFinder, Options options)
+    : m_pathFinder(pathFinder), m_options(std::move(options)),
+      m_workers(std::max<size_t>(m_options.engines.size(), 1))
+{
+    std::vector<Engine> engines = m_options.engines;
+    std::sort(engines.begin(), engines.end());
+    if (engines.empty() || std::adjacent_find(engines.begin(), engines.end()) != engines.end())
+    {
+        throw std::invalid_argument("Portfolio needs distinct engines");
+    }
+    if (std::binary_search(engines.begin(), engines.end(), Engine::ContractionHierarchy) &&
+        !m_pathFinder.HasContractionHierarchy())
+    {
+        throw std::invalid_argument("Portfolio engine needs a contraction hierarchy");
+    }
+}
+
+/**
+ * @brief Race the engines on a query and return the first answer. Every engine is optimal, so the
+ * first answer is the answer; the other engines stop at their next stop check and are joined
+ * before returning. Safe to call from several threads, queries then share the worker threads
+ *
+ * @param start,target Start and target cell
+ *
+ * @return Result with the path and the engine that found it
+ *
+ */
+PortfolioSearch::Result PortfolioSearch::FindPath(const Position &start,
+                                                  const Position &target) const
+{
+    TraceSpan span("PortfolioSearch::FindPath");
+    Result result;
+    if (!m_pathFinder.AreConnected(start, target))
+    {
+        return result;
+    }
+
+    std::mutex mutex;
+    std::atomic<bool> answered = false;
+    std::vector<std::future<void>> runs;
+    runs.reserve(m_options.engines.size());
+    for (Engine engine : m_options.engines)
+    {
+        runs.push_back(m_workers.Submit([&, engine]() mutable {
+            bool stopped = false;
+            const std::function<bool()> shouldStop = [&answered, &stopped]() {
+                stopped = answered.load(std::memory_order_relaxed);
+                return stopped;
+            };
+            std::vector<Position> path = runEngine(engine, start, target, shouldStop);
+            std::lock_guard<std::mutex> lock(mutex);
+            // Engines are only stopped once another one answered, so any earlier return is final
+            if (!answered)
+            {
+                result.path = std::move(path);
+                result.winner = engine;
+                answered = true;
+            }
+            result.stoppedEngines += stopped;
+        }));
+    }
+    for (auto &run : runs)
+    {
+        run.get();
+    }
+
+    if (result.winner)
+    {
+        ++m_wins[static_cast<size_t>(*result.winner)];
+    }
+    return result;
+}
+
+/**
+ * @brief Number of queries an engine answered first since the portfolio was created
+ *
+ */
+uint64_t PortfolioSearch::GetWins(Engine engine) const
+{
+    return m_wins[static_cast<size_t>(engine)];
+}
+
+/**
+ * @brief Run one engine on a query
+ *
+ * @param engine Engine to run, set to the engine that actually ran
+ * @param start,target Start and target cell
+ * @param shouldStop Cancels the engine once another one answered
+ *
+ * @return vector<Position> path, empty if none exists or the engine was stopped
+ *
+ */
+std::vector<Position> PortfolioSearch::runEngine(Engine &engine, const Position &start,
+                                                 const Position &target,
+                                                 const std::function<bool()> &shouldStop) const
+{
+    switch (engine)
+    {
+    case Engine::AStar:
+    {
+        PathFinder::QueryOptions options;
+        options.shouldStop = shouldStop;
+        options.useContractionHierarchy = false;
+        return m_pathFinder.FindPath(start, target, options);
+    }
+    case Engine::ContractionHierarchy:
+    {
+        const auto version = m_pathFinder.GetMapVersion();
+        if (version->contractionHierarchy)
+        {
+            return version->contractionHierarchy->FindPath(start, target);
+        }
+        // A terrain edit dropped the hierarchy, A* answers instead and is credited for it
+        engine = Engine::AStar;
+        PathFinder::QueryOptions options;
+        options.shouldStop = shouldStop;
+        options.useContractionHierarchy = false;
+        return m_pathFinder.FindPath(start, target, options);
+    }
+    case Engine::Frontier:
+        return FrontierSearch(m_pathFinder).FindPath(start, target, shouldStop).path;
+    }
+    return {};
+}
@@ -0,0 +1,80 @@
+#ifndef PORTFOLIO_SEARCH_HPP
+#define PORTFOLIO_SEARCH_HPP
+
+// Local lib includes
+#include "PathFinder.hpp"
+#include "ThreadPool.hpp"
+
+// Standard Includes
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace PathPlanner
+{
+// Races several optimal search engines on the same query, one thread each. The first engine to
+// finish answers the query and the others are cancelled through their stop checks. Which engine
+// wins is reported per query and counted, so a predictor choosing engines ahead of time can be
+// tuned on real queries.
+class PortfolioSearch
+{
+  public:
+    using Position = PathFinder::Position;
+
+    enum class Engine
+    {
+        // FindPath without the contraction hierarchy
+        AStar,
+        // Requires a contraction hierarchy, which cannot be cancelled but answers quickly. Once an
+        // edit dropped the hierarchy, A* runs in its place and answers as AStar
+        ContractionHierarchy,
+        // FrontierSearch without a memory limit
+        Frontier,
+    };
+    static constexpr size_t EngineCount = 3;
+
+    struct Options
+    {
+        // Engines raced on every query, each on its own worker thread
+        std::vector<Engine> engines = {Engine::AStar, Engine::Frontier};
+    };
+
+    struct Result
+    {
+        // Single cell 4-connected shortest path, empty if none exists
+        std::vector<Position> path;
+        // Engine that answered, empty if the query was rejected without searching
+        std::optional<Engine> winner;
+        // Engines cancelled by the answer before they finished
+        size_t stoppedEngines = 0;
+    };
+
+    // Constructor
+    PortfolioSearch(const PathFinder &pathFinder, Options options);
+    explicit PortfolioSearch(const PathFinder &pathFinder)
+        : PortfolioSearch(pathFinder, Options())
+    {
+    }
+
+    // Public methods
+    Result FindPath(const Position &start, const Position &target) const;
+    uint64_t GetWins(Engine engine) const;
+
+  private:
+    // Private members
+    const PathFinder &m_pathFinder;
+    Options m_options;
+    // The pool is thread safe, queries only submit to it
+    mutable ThreadPool m_workers;
+    mutable std::array<std::atomic<uint64_t>, EngineCount> m_wins{};
+
+    // Private methods
+    std::vector<Position> runEngine(Engine &engine, const Position &start, const Position &target,
+                                    const std::function<bool()> &shouldStop) const;
+};
+} // namespace PathPlanner
+
+#endif // PORTFOLIO_SEARCH_HPP
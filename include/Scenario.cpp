@@ -0,0 +1,157 @@
+// Local lib includes
+#include "Scenario.hpp"
+#include "Tracer.hpp"
+
+// Standard Includes
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+using namespace PathPlanner;
+using Position = PathPlanner::PathFinder::Position;
+
+/**
+ * @brief Read a Moving AI scenario file. The optional "version" header line is skipped, every
+ * other line holds bucket, map, map width, map height, start x, start y, goal x, goal y and the
+ * optimal length. Scenario x coordinates are columns, so they become the y of a Position
+ *
+ * @param filePath Path of the .scen file
+ *
+ * @return Scenario with the queries in file order
+ *
+ */
+Scenario Scenario::Load(const std::string &filePath)
+{
+    TraceSpan span("Scenario::Load");
+    std::ifstream file(filePath);
+    if (!file.is_open())
+    {
+        std::cerr << "Scenario parsing error at file: " << __FILE__ << ", line: " << __LINE__
+                  << std::endl;
+        throw std::runtime_error("Failed to open scenario file: " + filePath);
+    }
+
+    Scenario scenario;
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        ++lineNumber;
+        if (line.empty() || line.starts_with("version"))
+        {
+            continue;
+        }
+        std::istringstream fields(line);
+        Query query;
+        int startX, startY, targetX, targetY;
+        if (!(fields >> query.bucket >> query.mapName >> query.mapWidth >> query.mapHeight >>
+              startX >> startY >> targetX >> targetY >> query.optimalLength))
+        {
+            std::cerr << "Scenario parsing error at file: " << __FILE__ << ", line: " << __LINE__
+                      << std::endl;
+            throw std::runtime_error("Malformed query on line " + std::to_string(lineNumber) +
+                                     " of " + filePath);
+        }
+        query.start = {startY, startX};
+        query.target = {targetY, targetX};
+        scenario.m_queries.push_back(std::move(query));
+    }
+    return scenario;
+}
+
+/**
+ * @brief Plan every query with diagonal moves and compare the path lengths with the optimal
+ * lengths of the scenario. Queries run one at a time so the latencies are not skewed by
+ * contention
+ *
+ * @param pathFinder PathFinder holding the map of the scenario
+ *
+ * @return Report with one entry per bucket in ascending bucket order and the failed queries
+ *
+ */
+Scenario::Report Scenario::Run(const PathFinder &pathFinder) const
+{
+    TraceSpan span("Scenario::Run");
+    const auto version = pathFinder.GetMapVersion();
+    PathFinder::QueryOptions options;
+    options.allowDiagonal = true;
+
+    Report report;
+    std::map<int, std::vector<double>> latencies;
+    std::map<int, size_t> failures;
+    for (size_t i = 0; i < m_queries.size(); ++i)
+    {
+        const Query &query = m_queries[i];
+        if (query.mapHeight != version->map.Rows() || query.mapWidth != version->map.Cols())
+        {
+            std::cerr << "Scenario error at file: " << __FILE__ << ", line: " << __LINE__
+                      << std::endl;
+            throw std::runtime_error("Scenario map " + query.mapName +
+                                     " does not match the size of the loaded map");
+        }
+
+        const auto begin = std::chrono::steady_clock::now();
+        const std::vector<Position> path = pathFinder.FindPath(query.start, query.target, options);
+        const auto end = std::chrono::steady_clock::now();
+        latencies[query.bucket].push_back(
+            std::chrono::duration<double, std::micro>(end - begin).count());
+
+        const double length = PathLength(path);
+        if (path.empty() || std::abs(length - query.optimalLength) >
+                                LengthTolerance * std::max(1.0, query.optimalLength))
+        {
+            ++failures[query.bucket];
+            report.failedQueries.push_back(i);
+        }
+    }
+
+    for (auto &[bucket, times] : latencies)
+    {
+        BucketReport entry;
+        entry.bucket = bucket;
+        entry.queries = times.size();
+        entry.failures = failures[bucket];
+        double total = 0;
+        for (double time : times)
+        {
+            total += time;
+        }
+        entry.queriesPerSecond = total > 0 ? times.size() * 1e6 / total : 0;
+
+        // Nearest rank percentiles
+        std::sort(times.begin(), times.end());
+        auto percentile = [&times](double p) {
+            const size_t rank = static_cast<size_t>(std::ceil(p * times.size()));
+            return times[std::max<size_t>(rank, 1) - 1];
+        };
+        entry.p50Microseconds = percentile(0.5);
+        entry.p90Microseconds = percentile(0.9);
+        entry.p99Microseconds = percentile(0.99);
+        entry.maxMicroseconds = times.back();
+        report.buckets.push_back(entry);
+    }
+    return report;
+}
+
+/**
+ * @brief Octile length of a path, straight moves count 1 and diagonal moves sqrt(2)
+ *
+ * @param path Consecutive cells of the path
+ *
+ * @return double length, 0 for empty and single cell paths
+ *
+ */
+double Scenario::PathLength(const std::vector<Position> &path)
+{
+    double length = 0;
+    for (size_t i = 1; i < path.size(); ++i)
+    {
+        const bool diagonal = path[i].x != path[i - 1].x && path[i].y != path[i - 1].y;
+        length += diagonal ? std::sqrt(2.0) : 1.0;
+    }
+    return length;
+}
@@ -0,0 +1,69 @@
+#ifndef SCENARIO_HPP
+#define SCENARIO_HPP
+
+// Local lib includes
+#include "PathFinder.hpp"
+
+// Standard Includes
+#include <string>
+#include <vector>
+
+namespace PathPlanner
+{
+// Query list in the Moving AI benchmark format (.scen). Every query names its map, a start, a
+// target and the optimal octile path length, and queries of similar length share a bucket. Run
+// plans every query with diagonal moves, checks the returned lengths against the optimal ones and
+// reports throughput and latency percentiles per bucket.
+class Scenario
+{
+  public:
+    using Position = PathFinder::Position;
+
+    struct Query
+    {
+        int bucket;
+        std::string mapName;
+        int mapWidth;
+        int mapHeight;
+        Position start;
+        Position target;
+        double optimalLength;
+    };
+
+    struct BucketReport
+    {
+        int bucket = 0;
+        size_t queries = 0;
+        // Queries without a path or with a path longer or shorter than the optimal length
+        size_t failures = 0;
+        double queriesPerSecond = 0;
+        double p50Microseconds = 0;
+        double p90Microseconds = 0;
+        double p99Microseconds = 0;
+        double maxMicroseconds = 0;
+    };
+
+    struct Report
+    {
+        std::vector<BucketReport> buckets;
+        // Index of every failed query in the scenario
+        std::vector<size_t> failedQueries;
+    };
+
+    // Relative difference to the optimal length tolerated, covers the rounding of the scenario
+    // files and of the fixed point diagonal cost
+    static constexpr double LengthTolerance = 1e-4;
+
+    // Public methods
+    static Scenario Load(const std::string &filePath);
+    const std::vector<Query> &GetQueries() const { return m_queries; }
+    Report Run(const PathFinder &pathFinder) const;
+    static double PathLength(const std::vector<Position> &path);
+
+  private:
+    // Private members
+    std::vector<Query> m_queries;
+};
+} // namespace PathPlanner
+
+#endif // SCENARIO_HPP
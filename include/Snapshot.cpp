@@ -0,0 +1,178 @@
+// Local lib includes
+#include "Snapshot.hpp"
+
+// Standard Includes
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+using namespace PathPlanner;
+
+namespace
+{
+// Snapshot layout: magic, source tag, section count, then {id, size, bytes} per section
+const char SnapshotMagic[8] = {'R', 'T', 'S', 'S', 'N', 'A', 'P', '1'};
+constexpr uint64_t FnvPrime = 0x100000001b3ull;
+
+template <typename T> void writeValue(std::ostream &stream, const T &value)
+{
+    stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T> bool readValue(std::istream &stream, T &value)
+{
+    stream.read(reinterpret_cast<char *>(&value), sizeof(T));
+    return static_cast<bool>(stream);
+}
+} // namespace
+
+/**
+ * @brief Load a snapshot if it exists, is well formed and was built from the expected inputs
+ *
+ * @param filePath Path to the snapshot file
+ * @param expectedTag Source tag computed from the current inputs
+ *
+ * @return the snapshot, or std::nullopt if it is missing, corrupt or stale
+ *
+ */
+std::optional<Snapshot> Snapshot::Load(const std::string &filePath, uint64_t expectedTag)
+{
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open())
+    {
+        return std::nullopt;
+    }
+
+    char magic[sizeof(SnapshotMagic)];
+    uint64_t sourceTag = 0;
+    uint32_t sectionCount = 0;
+    file.read(magic, sizeof(magic));
+    if (!file || std::memcmp(magic, SnapshotMagic, sizeof(magic)) != 0 ||
+        !readValue(file, sourceTag) || sourceTag != expectedTag || !readValue(file, sectionCount))
+    {
+        return std::nullopt;
+    }
+
+    Snapshot snapshot(sourceTag);
+    for (uint32_t i = 0; i < sectionCount; ++i)
+    {
+        uint32_t id = 0;
+        uint64_t size = 0;
+        if (!readValue(file, id) || !readValue(file, size))
+        {
+            return std::nullopt;
+        }
+        std::string bytes(size, '\0');
+        file.read(bytes.data(), static_cast<std::streamsize>(size));
+        if (!file)
+        {
+            return std::nullopt;
+        }
+        snapshot.m_sections[id] = std::move(bytes);
+    }
+    return snapshot;
+}
+
+/**
+ * @brief Write the snapshot. The file is written next to the destination first and renamed into
+ * place so concurrent readers never observe a partial snapshot
+ *
+ * @param filePath Destination path
+ *
+ */
+void Snapshot::Save(const std::string &filePath) const
+{
+    const std::string temporaryPath = filePath + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            std::cerr << "Snapshot error at file: " << __FILE__ << ", line: " << __LINE__
+                      << std::endl;
+            throw std::runtime_error("Failed to open snapshot file for writing: " + filePath);
+        }
+        file.write(SnapshotMagic, sizeof(SnapshotMagic));
+        writeValue<uint64_t>(file, m_sourceTag);
+        writeValue<uint32_t>(file, static_cast<uint32_t>(m_sections.size()));
+        for (const auto &[id, bytes] : m_sections)
+        {
+            writeValue<uint32_t>(file, id);
+            writeValue<uint64_t>(file, bytes.size());
+            file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        }
+        if (!file)
+        {
+            throw std::runtime_error("Failed to write snapshot file: " + filePath);
+        }
+    }
+    if (std::rename(temporaryPath.c_str(), filePath.c_str()) != 0)
+    {
+        std::remove(temporaryPath.c_str());
+        throw std::runtime_error("Failed to replace snapshot file: " + filePath);
+    }
+}
+
+/**
+ * @brief Store the serialized bytes of a section, replacing any previous content
+ *
+ */
+void Snapshot::SetSection(Section section, std::string bytes)
+{
+    m_sections[static_cast<uint32_t>(section)] = std::move(bytes);
+}
+
+/**
+ * @brief Access the serialized bytes of a section
+ *
+ * @return pointer to the bytes, nullptr if the snapshot has no such section
+ *
+ */
+const std::string *Snapshot::GetSection(Section section) const
+{
+    auto found = m_sections.find(static_cast<uint32_t>(section));
+    return found == m_sections.end() ? nullptr : &found->second;
+}
+
+/**
+ * @brief Hash a block of memory with 64 bit FNV-1a
+ *
+ * @param data,size Memory to hash
+ * @param seed Hash of preceding data, allows hashing several blocks in sequence
+ *
+ */
+uint64_t Snapshot::HashBytes(const void *data, size_t size, uint64_t seed)
+{
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash = (hash ^ bytes[i]) * FnvPrime;
+    }
+    return hash;
+}
+
+/**
+ * @brief Hash the content of a file with 64 bit FNV-1a
+ *
+ * @param filePath File to hash
+ * @param seed Hash of preceding data
+ *
+ */
+uint64_t Snapshot::HashFile(const std::string &filePath, uint64_t seed)
+{
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Failed to open file for hashing: " + filePath);
+    }
+    uint64_t hash = seed;
+    std::vector<char> buffer(1 << 16);
+    while (file)
+    {
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        hash = HashBytes(buffer.data(), static_cast<size_t>(file.gcount()), hash);
+    }
+    return hash;
+}
@@ -0,0 +1,52 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+// Standard Includes
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+
+namespace PathPlanner
+{
+// Sectioned binary container for a parsed map and the structures precomputed from it. Every
+// snapshot carries a source tag, a hash of the inputs it was built from, and is only accepted
+// when the tag of the current inputs matches. Unknown sections are kept but ignored.
+class Snapshot
+{
+  public:
+    // Section ids are persisted, never renumber them
+    enum class Section : uint32_t
+    {
+        Grid = 1,
+        Positions = 2,
+        ComponentLabels = 3,
+        Clearance = 4,
+        ContractionHierarchy = 5,
+        MovementClasses = 6,
+    };
+
+    // Constructor
+    explicit Snapshot(uint64_t sourceTag) : m_sourceTag(sourceTag) {}
+
+    // Public methods
+    static std::optional<Snapshot> Load(const std::string &filePath, uint64_t expectedTag);
+    void Save(const std::string &filePath) const;
+    void SetSection(Section section, std::string bytes);
+    const std::string *GetSection(Section section) const;
+    uint64_t GetSourceTag() const { return m_sourceTag; }
+
+    // 64 bit FNV-1a hashing used to build source tags
+    static uint64_t HashBytes(const void *data, size_t size, uint64_t seed = FnvOffsetBasis);
+    static uint64_t HashFile(const std::string &filePath, uint64_t seed = FnvOffsetBasis);
+
+    static constexpr uint64_t FnvOffsetBasis = 0xcbf29ce484222325ull;
+
+  private:
+    // Private members
+    uint64_t m_sourceTag;
+    std::map<uint32_t, std::string> m_sections;
+};
+} // namespace PathPlanner
+
+#endif // SNAPSHOT_HPP
@@ -0,0 +1,64 @@
+// Local lib includes
+#include "ThreadPool.hpp"
+
+// Standard Includes
+#include <algorithm>
+
+using namespace PathPlanner;
+
+/**
+ * @brief Constructor for the ThreadPool Class. Starts the worker threads
+ *
+ * @param threadCount Number of workers, 0 selects the number of hardware threads
+ *
+ */
+ThreadPool::ThreadPool(size_t threadCount)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    m_workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i)
+    {
+        m_workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+/**
+ * @brief Destructor for the ThreadPool Class. Drains the remaining tasks and joins all workers
+ */
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+    for (auto &worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Worker thread body. Runs queued tasks until the pool is stopped and the queue is empty
+ */
+void ThreadPool::workerLoop()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+            if (m_tasks.empty())
+            {
+                return;
+            }
+            task = std::move(m_tasks.front());
+            m_tasks.pop();
+        }
+        task();
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+// Standard Includes
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace PathPlanner
+{
+// Fixed size pool of worker threads executing submitted tasks in FIFO order
+class ThreadPool
+{
+  public:
+    // Constructor, a thread count of 0 uses the number of hardware threads
+    explicit ThreadPool(size_t threadCount = 0);
+
+    // Destructor, finishes all queued tasks before joining the workers
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // Public methods
+    template <typename Task> std::future<std::invoke_result_t<Task>> Submit(Task &&task);
+    size_t Size() const { return m_workers.size(); }
+
+  private:
+    // Private members
+    std::vector<std::thread> m_workers;
+    std::queue<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping = false;
+
+    // Private methods
+    void workerLoop();
+};
+
+/**
+ * @brief Queue a task for execution on one of the worker threads
+ *
+ * @param task Callable without arguments
+ *
+ * @return std::future holding the result or exception of the task
+ *
+ */
+template <typename Task> std::future<std::invoke_result_t<Task>> ThreadPool::Submit(Task &&task)
+{
+    using Result = std::invoke_result_t<Task>;
+    auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<Task>(task));
+    std::future<Result> future = packaged->get_future();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.emplace([packaged]() { (*packaged)(); });
+    }
+    m_condition.notify_one();
+    return future;
+}
+} // namespace PathPlanner
+
+#endif // THREAD_POOL_HPP
@@ -0,0 +1,245 @@
+// Local lib includes
+#include "Tracer.hpp"
+
+// External lib includes
+#include <nlohmann/json.hpp> // Include nlohmann JSON library
+
+// Standard Includes
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+using namespace PathPlanner;
+
+std::atomic<bool> Tracer::s_enabled{false};
+
+namespace
+{
+// Single producer ring buffer owned by one thread. Every slot is guarded by a sequence number so
+// the exporter can read concurrently with the owner and skips slots that are being overwritten
+class ThreadBuffer
+{
+  public:
+    ThreadBuffer(uint32_t threadId, size_t capacity) : m_threadId(threadId), m_slots(capacity) {}
+
+    void Push(const Tracer::Event &event)
+    {
+        const uint64_t index = m_head.load(std::memory_order_relaxed);
+        Slot &slot = m_slots[index % m_slots.size()];
+        slot.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.name.store(event.name, std::memory_order_relaxed);
+        slot.category.store(event.category, std::memory_order_relaxed);
+        slot.startNs.store(event.startNs, std::memory_order_relaxed);
+        slot.durationNs.store(event.durationNs, std::memory_order_relaxed);
+        slot.argName.store(event.argName, std::memory_order_relaxed);
+        slot.argValue.store(event.argValue, std::memory_order_relaxed);
+        slot.sequence.store(index + 1, std::memory_order_release);
+        m_head.store(index + 1, std::memory_order_release);
+    }
+
+    // Copy the retained events, oldest first
+    std::vector<Tracer::Event> Collect() const
+    {
+        const uint64_t head = m_head.load(std::memory_order_acquire);
+        const uint64_t begin = head > m_slots.size() ? head - m_slots.size() : 0;
+        std::vector<Tracer::Event> events;
+        events.reserve(static_cast<size_t>(head - begin));
+        for (uint64_t index = begin; index < head; ++index)
+        {
+            const Slot &slot = m_slots[index % m_slots.size()];
+            if (slot.sequence.load(std::memory_order_acquire) != index + 1)
+            {
+                continue;
+            }
+            Tracer::Event event{slot.name.load(std::memory_order_relaxed),
+                                slot.category.load(std::memory_order_relaxed),
+                                slot.startNs.load(std::memory_order_relaxed),
+                                slot.durationNs.load(std::memory_order_relaxed),
+                                slot.argName.load(std::memory_order_relaxed),
+                                slot.argValue.load(std::memory_order_relaxed)};
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == index + 1)
+            {
+                events.push_back(event);
+            }
+        }
+        return events;
+    }
+
+    uint32_t ThreadId() const { return m_threadId; }
+
+  private:
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<const char *> name{nullptr};
+        std::atomic<const char *> category{nullptr};
+        std::atomic<int64_t> startNs{0};
+        std::atomic<int64_t> durationNs{0};
+        std::atomic<const char *> argName{nullptr};
+        std::atomic<int64_t> argValue{0};
+    };
+
+    uint32_t m_threadId;
+    std::vector<Slot> m_slots;
+    std::atomic<uint64_t> m_head{0};
+};
+
+// Buffers of all threads that recorded since the last Clear. The mutex is only taken when a
+// thread records its first span of a generation and when exporting
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::atomic<uint64_t> generation{1};
+    size_t capacity = Tracer::DefaultBufferCapacity;
+    uint32_t nextThreadId = 1;
+};
+
+Registry &registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+const std::chrono::steady_clock::time_point TraceEpoch = std::chrono::steady_clock::now();
+
+ThreadBuffer &localBuffer()
+{
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    thread_local uint64_t bufferGeneration = 0;
+
+    Registry &shared = registry();
+    const uint64_t generation = shared.generation.load(std::memory_order_acquire);
+    if (!buffer || bufferGeneration != generation)
+    {
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        buffer = std::make_shared<ThreadBuffer>(shared.nextThreadId++, shared.capacity);
+        shared.buffers.push_back(buffer);
+        bufferGeneration = shared.generation.load(std::memory_order_relaxed);
+    }
+    return *buffer;
+}
+} // namespace
+
+/**
+ * @brief Start recording spans
+ *
+ * @param bufferCapacity Number of spans retained per thread, applies to buffers created after the
+ * call
+ *
+ */
+void Tracer::Enable(size_t bufferCapacity)
+{
+    if (bufferCapacity == 0)
+    {
+        throw std::invalid_argument("Trace buffer capacity must be positive");
+    }
+    {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        registry().capacity = bufferCapacity;
+    }
+    s_enabled.store(true, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Stop recording spans. Already recorded spans are kept until Clear
+ */
+void Tracer::Disable()
+{
+    s_enabled.store(false, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Drop all recorded spans. Threads start a fresh buffer on their next span
+ */
+void Tracer::Clear()
+{
+    Registry &shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    shared.buffers.clear();
+    shared.nextThreadId = 1;
+    shared.generation.fetch_add(1, std::memory_order_release);
+}
+
+/**
+ * @brief Append a completed span to the calling thread's buffer
+ */
+void Tracer::Record(const Event &event)
+{
+    localBuffer().Push(event);
+}
+
+/**
+ * @brief Monotonic timestamp in nanoseconds since the process started
+ */
+int64_t Tracer::NowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                                TraceEpoch)
+        .count();
+}
+
+/**
+ * @brief Write all retained spans as Chrome trace-event JSON. Spans are complete ("X") events with
+ * microsecond timestamps, each recording thread is listed as its own track
+ *
+ * @param filePath Destination path of the trace
+ *
+ * @return size_t number of spans written
+ *
+ */
+size_t Tracer::WriteChromeTrace(const std::string &filePath)
+{
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        buffers = registry().buffers;
+    }
+
+    std::ofstream file(filePath, std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::cerr << "Trace export error at file: " << __FILE__ << ", line: " << __LINE__
+                  << std::endl;
+        throw std::runtime_error("Failed to open trace file for writing: " + filePath);
+    }
+
+    auto quoted = [](const char *text) { return nlohmann::json(text ? text : "").dump(); };
+
+    size_t written = 0;
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    file << std::fixed << std::setprecision(3);
+    for (const auto &buffer : buffers)
+    {
+        const uint32_t threadId = buffer->ThreadId();
+        file << (buffer != buffers.front() ? "," : "")
+             << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << threadId
+             << ",\"args\":{\"name\":\"Thread " << threadId << "\"}}";
+        for (const auto &event : buffer->Collect())
+        {
+            file << ",\n{\"name\":" << quoted(event.name) << ",\"cat\":" << quoted(event.category)
+                 << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << threadId
+                 << ",\"ts\":" << static_cast<double>(event.startNs) / 1000.0
+                 << ",\"dur\":" << static_cast<double>(event.durationNs) / 1000.0;
+            if (event.argName)
+            {
+                file << ",\"args\":{" << quoted(event.argName) << ":" << event.argValue << "}";
+            }
+            file << "}";
+            ++written;
+        }
+    }
+    file << "\n]}\n";
+    if (!file)
+    {
+        throw std::runtime_error("Failed to write trace file: " + filePath);
+    }
+    return written;
+}
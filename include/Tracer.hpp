@@ -0,0 +1,84 @@
+#ifndef TRACER_HPP
+#define TRACER_HPP
+
+// Standard Includes
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace PathPlanner
+{
+// Process wide recorder of timed spans, exported in the Chrome trace-event JSON format so a
+// timeline can be opened in chrome://tracing or Perfetto. Every thread records into its own
+// fixed size ring buffer without locking, the oldest spans of a thread are overwritten once its
+// buffer is full. Recording is off by default and costs a single relaxed load per span while off.
+class Tracer
+{
+  public:
+    static constexpr size_t DefaultBufferCapacity = 1 << 16;
+
+    // Completed span. Names, categories and argument names must be string literals or otherwise
+    // outlive the tracer, only the pointers are stored
+    struct Event
+    {
+        const char *name = nullptr;
+        const char *category = nullptr;
+        int64_t startNs = 0;
+        int64_t durationNs = 0;
+        const char *argName = nullptr;
+        int64_t argValue = 0;
+    };
+
+    // Public methods
+    static void Enable(size_t bufferCapacity = DefaultBufferCapacity);
+    static void Disable();
+    static bool IsEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+    static void Clear();
+    static void Record(const Event &event);
+    static int64_t NowNs();
+    static size_t WriteChromeTrace(const std::string &filePath);
+
+  private:
+    static std::atomic<bool> s_enabled;
+};
+
+// Records the lifetime of a scope as a span when tracing is enabled
+class TraceSpan
+{
+  public:
+    // Constructors
+    explicit TraceSpan(const char *name, const char *category = "PathFinder")
+        : TraceSpan(name, category, nullptr, 0)
+    {
+    }
+    TraceSpan(const char *name, const char *category, const char *argName, int64_t argValue)
+    {
+        if (Tracer::IsEnabled())
+        {
+            m_event = {name, category, Tracer::NowNs(), 0, argName, argValue};
+            m_active = true;
+        }
+    }
+
+    // Destructor, records the span
+    ~TraceSpan()
+    {
+        if (m_active)
+        {
+            m_event.durationNs = Tracer::NowNs() - m_event.startNs;
+            Tracer::Record(m_event);
+        }
+    }
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+  private:
+    // Private members
+    Tracer::Event m_event;
+    bool m_active = false;
+};
+} // namespace PathPlanner
+
+#endif // TRACER_HPP
@@ -0,0 +1,521 @@
+// Local lib includes
+#include "UnitSimulator.hpp"
+#include "Tracer.hpp"
+
+// Standard Includes
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+using namespace PathPlanner;
+using Position = PathPlanner::PathFinder::Position;
+
+/**
+ * @brief Constructor for the UnitSimulator Class
+ *
+ * @param pathFinder Plans and replans the unit paths, must outlive the simulator
+ * @param options Thresholds of the collision resolution. Throws std::invalid_argument if the replan
+ * radius is not positive or the backoff is outside [0, 8]
+ *
+ */
+UnitSimulator::UnitSimulator(const PathFinder &pathFinder, Options options)
+    : m_pathFinder(pathFinder), m_options(options),
+      m_cols(pathFinder.GetMapVersion()->map.Cols())
+{
+    if (m_options.replanRadius < 1 || m_options.maxReplanBackoff < 0 ||
+        m_options.maxReplanBackoff > 8)
+    {
+        throw std::invalid_argument("Replan radius must be positive and backoff within [0, 8]");
+    }
+}
+
+/**
+ * @brief Place a unit and plan its path
+ *
+ * @param start Traversable cell not occupied by another unit
+ * @param target Cell the unit walks to
+ *
+ * @return UnitId of the new unit, ids are assigned consecutively from 0. Throws
+ * std::invalid_argument if the start cell is blocked or occupied
+ *
+ */
+UnitSimulator::UnitId UnitSimulator::AddUnit(const Position &start, const Position &target)
+{
+    if (!m_pathFinder.IsTraversable(start) || IsOccupied(start))
+    {
+        throw std::invalid_argument("Unit start cell is blocked or occupied");
+    }
+
+    const UnitId unit = static_cast<UnitId>(m_x.size());
+    m_x.push_back(start.x);
+    m_y.push_back(start.y);
+    m_targetX.push_back(target.x);
+    m_targetY.push_back(target.y);
+    m_state.push_back(UnitState::Moving);
+    m_blockedTicks.push_back(0);
+    m_replanFailures.push_back(0);
+    m_sidestepped.push_back(0);
+    m_run.push_back(0);
+    m_step.push_back(0);
+    m_paths.push_back(m_pathFinder.FindCompressedPath(start, target));
+    if (start == target)
+    {
+        m_state[unit] = UnitState::Arrived;
+        ++m_stats.arrived;
+    }
+    else if (m_paths[unit].Empty())
+    {
+        m_state[unit] = UnitState::Stranded;
+    }
+
+    m_occupied.Reserve(m_x.size());
+    m_occupied.Insert(cellOf(start), unit);
+    return unit;
+}
+
+/**
+ * @brief Advance every moving unit by at most one cell. Units are updated in id order, so a cell
+ * left by a unit can be entered by a unit with a higher id in the same tick. Not thread safe
+ *
+ */
+void UnitSimulator::Tick()
+{
+    TraceSpan span("UnitSimulator::Tick");
+    const auto begin = std::chrono::steady_clock::now();
+    // Terrain edits take effect at tick boundaries
+    const auto version = m_pathFinder.GetMapVersion();
+
+    const size_t unitCount = m_x.size();
+    for (UnitId unit = 0; unit < unitCount; ++unit)
+    {
+        if (m_state[unit] != UnitState::Moving)
+        {
+            continue;
+        }
+
+        const CompressedPath::Run run = m_paths[unit].GetRun(m_run[unit]);
+        const Position next = CompressedPath::Step({m_x[unit], m_y[unit]}, run.direction);
+        if (!m_pathFinder.IsTraversable(*version, next))
+        {
+            // The terrain changed since the path was planned
+            setPath(unit, m_pathFinder.FindCompressedPath({m_x[unit], m_y[unit]},
+                                                          {m_targetX[unit], m_targetY[unit]}));
+            continue;
+        }
+        const UnitId occupant = m_occupied.Find(cellOf(next));
+        if (occupant != SpatialHash::NoUnit)
+        {
+            if (next.x == m_targetX[unit] && next.y == m_targetY[unit] &&
+                m_state[occupant] != UnitState::Moving)
+            {
+                // The target will not become free, stop next to it
+                m_state[unit] = UnitState::Arrived;
+                ++m_stats.arrived;
+                continue;
+            }
+            ++m_stats.waits;
+            const int blocked = ++m_blockedTicks[unit];
+            if (blocked >= m_options.replanAfterTicks << m_replanFailures[unit])
+            {
+                CompressedPath path = planAroundUnits(unit, *version);
+                if (path.Empty())
+                {
+                    // Boxed in, keep the path and sidestep while waiting longer for the next replan
+                    ++m_stats.failedReplans;
+                    m_blockedTicks[unit] = 0;
+                    if (m_replanFailures[unit] < m_options.maxReplanBackoff)
+                    {
+                        ++m_replanFailures[unit];
+                    }
+                }
+                else
+                {
+                    setPath(unit, std::move(path));
+                }
+            }
+            else if (blocked >= m_options.sidestepAfterTicks)
+            {
+                sidestep(unit, *version, next);
+            }
+            continue;
+        }
+
+        moveUnit(unit, next);
+        // Stepping back after a sidestep is no progress, the unit stays blocked until a replan
+        if (m_sidestepped[unit])
+        {
+            m_sidestepped[unit] = 0;
+        }
+        else
+        {
+            m_blockedTicks[unit] = 0;
+            m_replanFailures[unit] = 0;
+        }
+        if (++m_step[unit] == run.length)
+        {
+            m_step[unit] = 0;
+            if (++m_run[unit] == m_paths[unit].RunCount())
+            {
+                m_state[unit] = UnitState::Arrived;
+                ++m_stats.arrived;
+            }
+        }
+    }
+
+    ++m_stats.ticks;
+    m_tickSeconds +=
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    m_stats.ticksPerSecond = m_tickSeconds > 0 ? m_stats.ticks / m_tickSeconds : 0;
+}
+
+/**
+ * @brief Check whether a unit stands on a cell
+ *
+ */
+bool UnitSimulator::IsOccupied(const Position &pos) const
+{
+    return m_occupied.Contains(cellOf(pos));
+}
+
+/**
+ * @brief Move a unit to a free cell and update the spatial hash
+ *
+ */
+void UnitSimulator::moveUnit(UnitId unit, const Position &to)
+{
+    m_occupied.Erase(cellOf({m_x[unit], m_y[unit]}));
+    m_occupied.Insert(cellOf(to), unit);
+    m_x[unit] = to.x;
+    m_y[unit] = to.y;
+    ++m_stats.moves;
+}
+
+/**
+ * @brief Step aside to the free neighbor closest to the target. The path continues with a step
+ * back to the current cell, so the unit lets the blocking unit pass and rejoins its route
+ *
+ * @param unit Blocked unit
+ * @param version Map version of the current tick
+ * @param blocked Occupied cell the unit wanted to enter
+ *
+ * @return true if the unit moved
+ *
+ */
+bool UnitSimulator::sidestep(UnitId unit, const PathFinder::MapVersion &version,
+                             const Position &blocked)
+{
+    const Position current(m_x[unit], m_y[unit]);
+    const Position candidates[] = {{current.x + 1, current.y},
+                                   {current.x - 1, current.y},
+                                   {current.x, current.y + 1},
+                                   {current.x, current.y - 1}};
+    const Position *best = nullptr;
+    int bestDistance = std::numeric_limits<int>::max();
+    for (const auto &candidate : candidates)
+    {
+        if (candidate == blocked || !m_pathFinder.IsTraversable(version, candidate) ||
+            IsOccupied(candidate))
+        {
+            continue;
+        }
+        const int distance =
+            std::abs(candidate.x - m_targetX[unit]) + std::abs(candidate.y - m_targetY[unit]);
+        if (distance < bestDistance)
+        {
+            best = &candidate;
+            bestDistance = distance;
+        }
+    }
+    if (best == nullptr)
+    {
+        return false;
+    }
+
+    // Step back onto the path once the blocked cell frees up, no search needed
+    std::vector<Position> cells = {*best, current};
+    Position pos = current;
+    for (size_t run = m_run[unit]; run < m_paths[unit].RunCount(); ++run)
+    {
+        const CompressedPath::Run segment = m_paths[unit].GetRun(run);
+        const uint32_t taken = run == m_run[unit] ? m_step[unit] : 0;
+        for (uint32_t step = taken; step < segment.length; ++step)
+        {
+            pos = CompressedPath::Step(pos, segment.direction);
+            cells.push_back(pos);
+        }
+    }
+
+    moveUnit(unit, *best);
+    ++m_stats.sidesteps;
+    m_sidestepped[unit] = 1;
+    m_run[unit] = 0;
+    m_step[unit] = 0;
+    m_paths[unit] = CompressedPath(cells);
+    return true;
+}
+
+/**
+ * @brief Search a detour that leaves the path of a unit and rejoins it further along, inside the
+ * square window of replanRadius around the unit. Units in the window are obstacles, except one
+ * standing on the target. A breadth first search covers the window, so the cost is bounded by its
+ * size, and the detour minimizing the length of the whole remaining path is taken
+ *
+ * @param unit Unit to plan for
+ * @param version Map version of the current tick
+ *
+ * @return CompressedPath along the detour and the rest of the old path, empty if the path cannot
+ * be rejoined inside the window
+ *
+ */
+CompressedPath UnitSimulator::planAroundUnits(UnitId unit, const PathFinder::MapVersion &version)
+{
+    const int radius = m_options.replanRadius;
+    const int side = 2 * radius + 1;
+    const Position current(m_x[unit], m_y[unit]);
+    const Position target(m_targetX[unit], m_targetY[unit]);
+    const auto windowIndex = [&](const Position &pos) {
+        const int row = pos.x - current.x + radius;
+        const int col = pos.y - current.y + radius;
+        return row < 0 || col < 0 || row >= side || col >= side ? -1 : row * side + col;
+    };
+
+    // Steps along the remaining path to each of its cells, until the path leaves the window
+    m_windowPathIndex.assign(side * side, -1);
+    Position pos = current;
+    int32_t steps = 0;
+    for (size_t run = m_run[unit]; run < m_paths[unit].RunCount(); ++run)
+    {
+        const CompressedPath::Run segment = m_paths[unit].GetRun(run);
+        const uint32_t taken = run == m_run[unit] ? m_step[unit] : 0;
+        uint32_t step = taken;
+        for (; step < segment.length; ++step)
+        {
+            pos = CompressedPath::Step(pos, segment.direction);
+            const int cell = windowIndex(pos);
+            if (cell < 0)
+            {
+                break;
+            }
+            m_windowPathIndex[cell] = ++steps;
+        }
+        if (step < segment.length)
+        {
+            break;
+        }
+    }
+
+    m_windowDistance.assign(side * side, -1);
+    m_windowParent.assign(side * side, -1);
+    m_windowQueue.clear();
+    const int start = windowIndex(current);
+    m_windowDistance[start] = 0;
+    m_windowQueue.push_back(start);
+    int best = -1;
+    int bestCost = std::numeric_limits<int>::max();
+    for (size_t head = 0; head < m_windowQueue.size(); ++head)
+    {
+        const int cell = m_windowQueue[head];
+        if (cell != start && m_windowPathIndex[cell] > 0 &&
+            m_windowDistance[cell] - m_windowPathIndex[cell] < bestCost)
+        {
+            best = cell;
+            bestCost = m_windowDistance[cell] - m_windowPathIndex[cell];
+        }
+        const Position cellPos(current.x - radius + cell / side, current.y - radius + cell % side);
+        const Position neighbors[] = {{cellPos.x + 1, cellPos.y},
+                                      {cellPos.x - 1, cellPos.y},
+                                      {cellPos.x, cellPos.y + 1},
+                                      {cellPos.x, cellPos.y - 1}};
+        for (const auto &neighbor : neighbors)
+        {
+            const int next = windowIndex(neighbor);
+            if (next < 0 || m_windowDistance[next] >= 0 ||
+                !m_pathFinder.IsTraversable(version, neighbor) ||
+                (IsOccupied(neighbor) && !(neighbor == target)))
+            {
+                continue;
+            }
+            m_windowDistance[next] = m_windowDistance[cell] + 1;
+            m_windowParent[next] = cell;
+            m_windowQueue.push_back(next);
+        }
+    }
+    if (best < 0)
+    {
+        return CompressedPath();
+    }
+
+    // Detour from the unit to the rejoined cell, then the old path beyond it
+    std::vector<Position> cells;
+    for (int cell = best; cell >= 0; cell = m_windowParent[cell])
+    {
+        cells.push_back({current.x - radius + cell / side, current.y - radius + cell % side});
+    }
+    std::reverse(cells.begin(), cells.end());
+    pos = current;
+    steps = 0;
+    for (size_t run = m_run[unit]; run < m_paths[unit].RunCount(); ++run)
+    {
+        const CompressedPath::Run segment = m_paths[unit].GetRun(run);
+        const uint32_t taken = run == m_run[unit] ? m_step[unit] : 0;
+        for (uint32_t step = taken; step < segment.length; ++step)
+        {
+            pos = CompressedPath::Step(pos, segment.direction);
+            if (++steps > m_windowPathIndex[best])
+            {
+                cells.push_back(pos);
+            }
+        }
+    }
+    return CompressedPath(cells);
+}
+
+/**
+ * @brief Replace the path of a unit and restart it from its current cell
+ *
+ * @param unit Unit to update
+ * @param path New path, empty strands the unit unless it already stands on its target
+ *
+ */
+void UnitSimulator::setPath(UnitId unit, CompressedPath path)
+{
+    ++m_stats.replans;
+    m_blockedTicks[unit] = 0;
+    m_sidestepped[unit] = 0;
+    m_run[unit] = 0;
+    m_step[unit] = 0;
+    if (m_x[unit] == m_targetX[unit] && m_y[unit] == m_targetY[unit])
+    {
+        m_state[unit] = UnitState::Arrived;
+        ++m_stats.arrived;
+    }
+    else if (path.Empty())
+    {
+        m_state[unit] = UnitState::Stranded;
+    }
+    m_paths[unit] = std::move(path);
+}
+
+/**
+ * @brief Make room for the given number of units, keeping the load factor at or below one half
+ *
+ */
+void UnitSimulator::SpatialHash::Reserve(size_t units)
+{
+    if (units * 2 > m_slots.size())
+    {
+        size_t capacity = 16;
+        while (capacity < units * 2)
+        {
+            capacity *= 2;
+        }
+        rehash(capacity);
+    }
+}
+
+/**
+ * @brief Record the unit standing on a cell, the cell must be free
+ *
+ */
+void UnitSimulator::SpatialHash::Insert(int64_t cell, UnitId unit)
+{
+    size_t slot = home(cell);
+    while (m_slots[slot].cell != EmptyCell)
+    {
+        slot = (slot + 1) & m_mask;
+    }
+    m_slots[slot] = {cell, unit};
+    ++m_size;
+}
+
+/**
+ * @brief Free a cell. Following entries of the probe sequence are shifted back into the gap, so
+ * lookups never have to skip deleted slots
+ *
+ */
+void UnitSimulator::SpatialHash::Erase(int64_t cell)
+{
+    size_t slot = home(cell);
+    while (m_slots[slot].cell != cell)
+    {
+        if (m_slots[slot].cell == EmptyCell)
+        {
+            return;
+        }
+        slot = (slot + 1) & m_mask;
+    }
+
+    size_t next = slot;
+    while (true)
+    {
+        next = (next + 1) & m_mask;
+        if (m_slots[next].cell == EmptyCell)
+        {
+            break;
+        }
+        // Entries whose home lies cyclically in (slot, next] are still reachable, move the others
+        const size_t nextHome = home(m_slots[next].cell);
+        const bool reachable = slot <= next ? (slot < nextHome && nextHome <= next)
+                                            : (slot < nextHome || nextHome <= next);
+        if (!reachable)
+        {
+            m_slots[slot] = m_slots[next];
+            slot = next;
+        }
+    }
+    m_slots[slot] = Slot();
+    --m_size;
+}
+
+/**
+ * @brief Look up the unit standing on a cell
+ *
+ * @return UnitId of the unit, NoUnit if the cell is free
+ *
+ */
+UnitSimulator::UnitId UnitSimulator::SpatialHash::Find(int64_t cell) const
+{
+    if (m_slots.empty())
+    {
+        return NoUnit;
+    }
+    for (size_t slot = home(cell); m_slots[slot].cell != EmptyCell; slot = (slot + 1) & m_mask)
+    {
+        if (m_slots[slot].cell == cell)
+        {
+            return m_slots[slot].unit;
+        }
+    }
+    return NoUnit;
+}
+
+/**
+ * @brief Fibonacci hashing of the cell index onto the table
+ *
+ */
+size_t UnitSimulator::SpatialHash::home(int64_t cell) const
+{
+    return static_cast<size_t>((static_cast<uint64_t>(cell) * 0x9e3779b97f4a7c15ull) >> 32) &
+           m_mask;
+}
+
+/**
+ * @brief Move all entries into a table of the given power of two capacity
+ *
+ */
+void UnitSimulator::SpatialHash::rehash(size_t capacity)
+{
+    std::vector<Slot> slots(capacity);
+    slots.swap(m_slots);
+    m_mask = capacity - 1;
+    m_size = 0;
+    for (const auto &slot : slots)
+    {
+        if (slot.cell != EmptyCell)
+        {
+            Insert(slot.cell, slot.unit);
+        }
+    }
+}
@@ -0,0 +1,146 @@
+#ifndef UNIT_SIMULATOR_HPP
+#define UNIT_SIMULATOR_HPP
+
+// Local lib includes
+#include "CompressedPath.hpp"
+#include "PathFinder.hpp"
+
+// Standard Includes
+#include <cstdint>
+#include <vector>
+
+namespace PathPlanner
+{
+// Fixed tick simulation of units walking their planned paths. Every tick each moving unit tries to
+// advance one cell. A unit whose next cell is taken waits, sidesteps to a free neighbor after a
+// few ticks, and searches a detour around the units close to it when it stays blocked. A unit whose
+// target is held by a unit that stopped there settles next to it. Unit state is kept
+// as structure of arrays, and occupied cells are found through a spatial hash sized to the unit
+// count rather than the map, so a tick costs a few cache friendly array accesses per unit.
+class UnitSimulator
+{
+  public:
+    using Position = PathFinder::Position;
+    using UnitId = uint32_t;
+
+    enum class UnitState : uint8_t
+    {
+        Moving,
+        Arrived,
+        // No path to the target exists, the unit stands still
+        Stranded,
+    };
+
+    struct Options
+    {
+        // Blocked ticks before a unit sidesteps
+        int sidestepAfterTicks = 2;
+        // Blocked ticks before a unit replans around nearby units
+        int replanAfterTicks = 6;
+        // Half size of the square window around the unit in which a replan searches a detour back
+        // onto its path. Units in the window are obstacles, and a replan examines at most
+        // (2 * replanRadius + 1)^2 cells
+        int replanRadius = 6;
+        // Every failed replan of a unit doubles its blocked ticks before the next replan, up to
+        // this many times, until the unit makes progress again
+        int maxReplanBackoff = 4;
+    };
+
+    struct Stats
+    {
+        uint64_t ticks = 0;
+        uint64_t moves = 0;
+        uint64_t waits = 0;
+        uint64_t sidesteps = 0;
+        uint64_t replans = 0;
+        // Replans that found no detour inside the window
+        uint64_t failedReplans = 0;
+        size_t arrived = 0;
+        // Wall clock rate of Tick calls so far
+        double ticksPerSecond = 0;
+    };
+
+    // Constructor
+    UnitSimulator(const PathFinder &pathFinder, Options options);
+    explicit UnitSimulator(const PathFinder &pathFinder) : UnitSimulator(pathFinder, Options()) {}
+
+    // Public methods
+    UnitId AddUnit(const Position &start, const Position &target);
+    void Tick();
+    size_t GetUnitCount() const { return m_x.size(); }
+    Position GetPosition(UnitId unit) const { return {m_x.at(unit), m_y.at(unit)}; }
+    UnitState GetState(UnitId unit) const { return m_state.at(unit); }
+    bool IsOccupied(const Position &pos) const;
+    const Stats &GetStats() const { return m_stats; }
+
+  private:
+    // Open addressing hash from occupied cell to unit, with linear probing and backward shift
+    // deletion so no tombstones build up while units move
+    class SpatialHash
+    {
+      public:
+        void Reserve(size_t units);
+        void Insert(int64_t cell, UnitId unit);
+        void Erase(int64_t cell);
+        UnitId Find(int64_t cell) const;
+        bool Contains(int64_t cell) const { return Find(cell) != NoUnit; }
+
+        static constexpr UnitId NoUnit = UINT32_MAX;
+
+      private:
+        static constexpr int64_t EmptyCell = -1;
+
+        struct Slot
+        {
+            int64_t cell = EmptyCell;
+            UnitId unit = 0;
+        };
+
+        std::vector<Slot> m_slots;
+        size_t m_mask = 0;
+        size_t m_size = 0;
+
+        size_t home(int64_t cell) const;
+        void rehash(size_t capacity);
+    };
+
+    // Private members
+    const PathFinder &m_pathFinder;
+    Options m_options;
+    int m_cols;
+    // Unit state, indexed by unit id
+    std::vector<int32_t> m_x;
+    std::vector<int32_t> m_y;
+    std::vector<int32_t> m_targetX;
+    std::vector<int32_t> m_targetY;
+    std::vector<UnitState> m_state;
+    std::vector<uint16_t> m_blockedTicks;
+    std::vector<uint8_t> m_replanFailures;
+    // The next move returns to the path after a sidestep
+    std::vector<uint8_t> m_sidestepped;
+    // Cursor into the path: current run and moves already made in it
+    std::vector<uint32_t> m_run;
+    std::vector<uint32_t> m_step;
+    std::vector<CompressedPath> m_paths;
+    SpatialHash m_occupied;
+    // Scratch buffers of the detour search, one entry per window cell
+    std::vector<int32_t> m_windowDistance;
+    std::vector<int32_t> m_windowParent;
+    std::vector<int32_t> m_windowPathIndex;
+    std::vector<int32_t> m_windowQueue;
+    Stats m_stats;
+    double m_tickSeconds = 0;
+
+    // Private methods
+    int64_t cellOf(const Position &pos) const
+    {
+        return static_cast<int64_t>(pos.x) * m_cols + pos.y;
+    }
+    void moveUnit(UnitId unit, const Position &to);
+    bool sidestep(UnitId unit, const PathFinder::MapVersion &version, const Position &blocked);
+    CompressedPath planAroundUnits(UnitId unit, const PathFinder::MapVersion &version);
+    void setPath(UnitId unit, CompressedPath path);
+};
+} // namespace PathPlanner
+
+#endif // UNIT_SIMULATOR_HPP
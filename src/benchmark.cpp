@@ -0,0 +1,223 @@
+// Local library includes
+#include <PathFinder.hpp>
+#include <Scenario.hpp>
+#include <UnitSimulator.hpp>
+
+// Standard includes
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+// Write a square map with randomly placed obstacles and a config pointing at it
+void writeRandomMap(const std::string &configFile, const std::string &mapFile, int size,
+                    int obstaclePercent, bool contractionHierarchy, std::mt19937 &random)
+{
+    std::vector<int> data(size * size);
+    for (auto &cell : data)
+    {
+        cell = static_cast<int>(random() % 100) < obstaclePercent ? 3 : -1;
+    }
+    nlohmann::json mapData;
+    mapData["layers"] = {{{"name", "world"},
+                          {"tileset", "MapEditor Tileset_woodland.png"},
+                          {"data", data}}};
+    mapData["tilesets"] = {{{"name", "MapEditor Tileset_woodland.png"},
+                            {"tilewidth", size},
+                            {"tileheight", size}}};
+    std::ofstream(mapFile) << mapData;
+
+    nlohmann::json config = {
+        {"mapFile", mapFile},
+        {"headless", true},
+        {"contractionHierarchy", contractionHierarchy},
+        {"terrainKeys", {{"start", 0}, {"target", 8}, {"elevated", 3}, {"reachable", -1}}}};
+    std::ofstream(configFile) << config;
+}
+
+// Seconds elapsed since a time point
+double secondsSince(std::chrono::steady_clock::time_point begin)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+// Simulate units walking between random cells of a generated map and print the simulator stats.
+// The map, starts and targets only depend on the seed, so runs are reproducible
+int runUnits(int size, int obstaclePercent, size_t unitCount, int ticks, unsigned seed)
+{
+    std::mt19937 random(seed);
+    const std::string configFile = "benchmark_units_config.json";
+    const std::string mapFile = "benchmark_units_map.json";
+    writeRandomMap(configFile, mapFile, size, obstaclePercent, false, random);
+    PathPlanner::PathFinder pathFinder(configFile);
+    std::remove(configFile.c_str());
+    std::remove(mapFile.c_str());
+
+    std::vector<PathPlanner::PathFinder::Position> cells;
+    for (int x = 0; x < size; ++x)
+    {
+        for (int y = 0; y < size; ++y)
+        {
+            if (pathFinder.IsTraversable({x, y}))
+            {
+                cells.push_back({x, y});
+            }
+        }
+    }
+    if (unitCount > cells.size())
+    {
+        std::cerr << "Only " << cells.size() << " traversable cells for the units" << std::endl;
+        return 1;
+    }
+    std::vector<PathPlanner::PathFinder::Position> targets = cells;
+    std::shuffle(cells.begin(), cells.end(), random);
+    std::shuffle(targets.begin(), targets.end(), random);
+
+    const auto begin = std::chrono::steady_clock::now();
+    PathPlanner::UnitSimulator simulator(pathFinder);
+    for (size_t i = 0; i < unitCount; ++i)
+    {
+        simulator.AddUnit(cells[i], targets[i]);
+    }
+    const double planSeconds = secondsSince(begin);
+    for (int tick = 0; tick < ticks; ++tick)
+    {
+        simulator.Tick();
+    }
+
+    const auto &stats = simulator.GetStats();
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "units plan_s ticks ticks/s moves waits sidesteps replans failed_replans arrived"
+              << std::endl;
+    std::cout << unitCount << " " << planSeconds << " " << stats.ticks << " "
+              << stats.ticksPerSecond << " " << stats.moves << " " << stats.waits << " "
+              << stats.sidesteps << " " << stats.replans << " " << stats.failedReplans << " "
+              << stats.arrived << std::endl;
+    return 0;
+}
+
+// Answer random connected queries on a generated map with the contraction hierarchy and with A*,
+// check that the path lengths agree and print the load time including the build and both totals
+int runHierarchy(int size, int obstaclePercent, int queryCount, unsigned seed)
+{
+    std::mt19937 random(seed);
+    const std::string configFile = "benchmark_hierarchy_config.json";
+    const std::string mapFile = "benchmark_hierarchy_map.json";
+    writeRandomMap(configFile, mapFile, size, obstaclePercent, true, random);
+    const auto loadBegin = std::chrono::steady_clock::now();
+    PathPlanner::PathFinder pathFinder(configFile);
+    const double loadSeconds = secondsSince(loadBegin);
+    std::remove(configFile.c_str());
+    std::remove(mapFile.c_str());
+
+    std::vector<std::pair<PathPlanner::PathFinder::Position, PathPlanner::PathFinder::Position>>
+        queries;
+    while (static_cast<int>(queries.size()) < queryCount)
+    {
+        const PathPlanner::PathFinder::Position start(random() % size, random() % size);
+        const PathPlanner::PathFinder::Position target(random() % size, random() % size);
+        if (pathFinder.IsTraversable(start) && pathFinder.IsTraversable(target) &&
+            pathFinder.AreConnected(start, target))
+        {
+            queries.push_back({start, target});
+        }
+    }
+
+    std::vector<size_t> lengths;
+    const auto hierarchyBegin = std::chrono::steady_clock::now();
+    for (const auto &[start, target] : queries)
+    {
+        lengths.push_back(pathFinder.FindPath(start, target).size());
+    }
+    const double hierarchySeconds = secondsSince(hierarchyBegin);
+
+    PathPlanner::PathFinder::QueryOptions options;
+    options.useContractionHierarchy = false;
+    int mismatches = 0;
+    const auto searchBegin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        mismatches += pathFinder.FindPath(queries[i].first, queries[i].second, options).size() !=
+                      lengths[i];
+    }
+    const double searchSeconds = secondsSince(searchBegin);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "queries load_s hierarchy_ms astar_ms speedup mismatches" << std::endl;
+    std::cout << queries.size() << " " << loadSeconds << " " << hierarchySeconds * 1000 << " "
+              << searchSeconds * 1000 << " " << searchSeconds / hierarchySeconds << " "
+              << mismatches << std::endl;
+    return mismatches == 0 ? 0 : 2;
+}
+} // namespace
+
+// Run a Moving AI scenario against the map of a config file, validate every path length and print
+// throughput and latency percentiles per bucket. With --units, simulate units on a generated map,
+// and with --hierarchy, compare contraction hierarchy queries against A* on a generated map
+int main(int argc, char **argv)
+{
+    const std::string mode = argc > 1 ? argv[1] : "";
+    if (argc < 3 || (mode == "--units" && argc < 6) || (mode == "--hierarchy" && argc < 5))
+    {
+        std::cerr << "Usage: " << argv[0] << " <config file with a .map file> <scenario file>\n"
+                  << "       " << argv[0]
+                  << " --units <map size> <obstacle percent> <unit count> <ticks> [seed]\n"
+                  << "       " << argv[0]
+                  << " --hierarchy <map size> <obstacle percent> <queries> [seed]" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        if (mode == "--units")
+        {
+            return runUnits(std::stoi(argv[2]), std::stoi(argv[3]), std::stoul(argv[4]),
+                            std::stoi(argv[5]), argc > 6 ? std::stoul(argv[6]) : 1);
+        }
+        if (mode == "--hierarchy")
+        {
+            return runHierarchy(std::stoi(argv[2]), std::stoi(argv[3]), std::stoi(argv[4]),
+                                argc > 5 ? std::stoul(argv[5]) : 1);
+        }
+
+        PathPlanner::PathFinder pathFinder(argv[1]);
+        const PathPlanner::Scenario scenario = PathPlanner::Scenario::Load(argv[2]);
+        std::cout << "Running " << scenario.GetQueries().size() << " queries" << std::endl;
+        const PathPlanner::Scenario::Report report = scenario.Run(pathFinder);
+
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "bucket queries failures queries/s p50us p90us p99us maxus" << std::endl;
+        for (const auto &bucket : report.buckets)
+        {
+            std::cout << bucket.bucket << " " << bucket.queries << " " << bucket.failures << " "
+                      << bucket.queriesPerSecond << " " << bucket.p50Microseconds << " "
+                      << bucket.p90Microseconds << " " << bucket.p99Microseconds << " "
+                      << bucket.maxMicroseconds << std::endl;
+        }
+
+        const auto &queries = scenario.GetQueries();
+        for (size_t index : report.failedQueries)
+        {
+            const auto &query = queries[index];
+            std::cerr << "Query " << index << " from (" << query.start.x << ", " << query.start.y
+                      << ") to (" << query.target.x << ", " << query.target.y
+                      << ") does not match the optimal length " << query.optimalLength
+                      << std::endl;
+        }
+        return report.failedQueries.empty() ? 0 : 2;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,54 @@
+// Local library includes
+#include <PathClient.hpp>
+
+// Standard includes
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Send one batch of queries to a running path server and print the resulting paths
+int main(int argc, char **argv)
+{
+    if (argc < 7 || (argc - 3) % 4 != 0)
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " <socket path> <map id> <start x> <start y> <target x> <target y> [...]"
+                  << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        PathPlanner::PathClient client(argv[1]);
+        const uint32_t mapId = static_cast<uint32_t>(std::stoul(argv[2]));
+
+        std::vector<PathPlanner::PathClient::Query> queries;
+        for (int i = 3; i < argc; i += 4)
+        {
+            queries.push_back({{std::stoi(argv[i]), std::stoi(argv[i + 1])},
+                               {std::stoi(argv[i + 2]), std::stoi(argv[i + 3])}});
+        }
+
+        const auto paths = client.FindPaths(mapId, queries);
+        for (size_t i = 0; i < paths.size(); ++i)
+        {
+            if (paths[i].empty())
+            {
+                std::cout << "No valid path found for query " << i << std::endl;
+                continue;
+            }
+            std::cout << "Path for query " << i << ":" << std::endl;
+            for (const auto &pos : paths[i])
+            {
+                std::cout << "(" << pos.x << ", " << pos.y << ") ";
+            }
+            std::cout << std::endl;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
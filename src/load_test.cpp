@@ -0,0 +1,96 @@
+// Local library includes
+#include <PathClient.hpp>
+
+// Standard includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Drive a running path server with random batched queries from several connections and report
+// throughput and batch latency percentiles
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " <socket path> [map id] [connections] [batches per connection] [batch size]"
+                  << std::endl;
+        return 1;
+    }
+    const std::string socketPath = argv[1];
+    const uint32_t mapId = argc > 2 ? static_cast<uint32_t>(std::stoul(argv[2])) : 0;
+    const int connections = argc > 3 ? std::stoi(argv[3]) : 4;
+    const int batches = argc > 4 ? std::stoi(argv[4]) : 100;
+    const int batchSize = argc > 5 ? std::stoi(argv[5]) : 64;
+
+    try
+    {
+        PathPlanner::Protocol::MapInfo info = PathPlanner::PathClient(socketPath).GetMapInfo(mapId);
+        std::cout << "Map " << mapId << ": " << info.rows << " x " << info.cols << std::endl;
+
+        std::vector<std::vector<double>> latencies(connections);
+        std::atomic<size_t> foundPaths{0};
+        const auto begin = std::chrono::steady_clock::now();
+
+        std::vector<std::thread> workers;
+        for (int c = 0; c < connections; ++c)
+        {
+            workers.emplace_back([&, c]() {
+                PathPlanner::PathClient client(socketPath);
+                std::mt19937 random(static_cast<unsigned>(c));
+                std::uniform_int_distribution<int> row(0, info.rows - 1), col(0, info.cols - 1);
+                std::vector<PathPlanner::PathClient::Query> queries(batchSize);
+                for (int b = 0; b < batches; ++b)
+                {
+                    for (auto &query : queries)
+                    {
+                        query = {{row(random), col(random)}, {row(random), col(random)}};
+                    }
+                    const auto sent = std::chrono::steady_clock::now();
+                    const auto paths = client.FindPaths(mapId, queries);
+                    const auto received = std::chrono::steady_clock::now();
+                    latencies[c].push_back(
+                        std::chrono::duration<double, std::milli>(received - sent).count());
+                    for (const auto &path : paths)
+                    {
+                        foundPaths += !path.empty();
+                    }
+                }
+            });
+        }
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+
+        const double seconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        std::vector<double> all;
+        for (const auto &connectionLatencies : latencies)
+        {
+            all.insert(all.end(), connectionLatencies.begin(), connectionLatencies.end());
+        }
+        std::sort(all.begin(), all.end());
+        auto percentile = [&all](double p) {
+            return all.empty() ? 0.0 : all[std::min(all.size() - 1, size_t(p * all.size()))];
+        };
+
+        const size_t totalQueries = static_cast<size_t>(connections) * batches * batchSize;
+        std::cout << "Queries: " << totalQueries << " (" << foundPaths << " with a path)"
+                  << std::endl;
+        std::cout << "Throughput: " << totalQueries / seconds << " queries/s" << std::endl;
+        std::cout << "Batch latency ms p50: " << percentile(0.5) << " p90: " << percentile(0.9)
+                  << " p99: " << percentile(0.99) << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -1,17 +1,86 @@
 // Local library includes
 #include <PathFinder.hpp>
+#include <PathServer.hpp>
+#include <Tracer.hpp>
 
 // Standard includes
+#include <csignal>
 #include <iostream>
+#include <string>
+#include <vector>
 
-int main()
+namespace
+{
+PathPlanner::PathServer *activeServer = nullptr;
+
+void handleStopSignal(int)
+{
+    if (activeServer)
+    {
+        activeServer->Stop();
+    }
+}
+
+// Keep the given maps resident and answer queries on a Unix domain socket until interrupted
+int runServer(const std::string &socketPath, std::vector<std::string> configFiles)
+{
+    if (configFiles.empty())
+    {
+        configFiles.push_back("data/config.json");
+    }
+    PathPlanner::PathServer server(configFiles, socketPath);
+    activeServer = &server;
+    std::signal(SIGINT, handleStopSignal);
+    std::signal(SIGTERM, handleStopSignal);
+    server.Run();
+    activeServer = nullptr;
+    return 0;
+}
+} // namespace
+
+int main(int argc, char **argv)
 {
     std::cout << "Path Finding algorithm for a Real-Time Stategy game" << std::endl;
 
-    const std::string filePath = "data/config.json";
-    PathPlanner::PathFinder pathFinder(filePath);
+    std::vector<std::string> args(argv + 1, argv + argc);
 
-    pathFinder.FindPaths();
+    // Record a Chrome trace-event timeline of the run
+    std::string traceFile;
+    if (!args.empty() && args[0] == "--trace")
+    {
+        if (args.size() < 2)
+        {
+            std::cerr << "Usage: " << argv[0] << " --trace <trace file> [--serve ...]" << std::endl;
+            return 1;
+        }
+        traceFile = args[1];
+        args.erase(args.begin(), args.begin() + 2);
+        PathPlanner::Tracer::Enable();
+    }
 
-    return 0;
-}
\ No newline at end of file
+    int result = 0;
+    if (!args.empty() && args[0] == "--serve")
+    {
+        if (args.size() < 2)
+        {
+            std::cerr << "Usage: " << argv[0] << " --serve <socket path> [config file ...]"
+                      << std::endl;
+            return 1;
+        }
+        result = runServer(args[1], std::vector<std::string>(args.begin() + 2, args.end()));
+    }
+    else
+    {
+        const std::string filePath = "data/config.json";
+        PathPlanner::PathFinder pathFinder(filePath);
+
+        pathFinder.FindPaths();
+    }
+
+    if (!traceFile.empty())
+    {
+        size_t spans = PathPlanner::Tracer::WriteChromeTrace(traceFile);
+        std::cout << "Wrote " << spans << " trace spans to " << traceFile << std::endl;
+    }
+    return result;
+}
@@ -0,0 +1,251 @@
+#include "../include/CBSSolver.hpp"
+#include "../include/PathFinder.hpp"
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstdio>
+
+using namespace PathPlanner;
+using Position = PathPlanner::PathFinder::Position;
+
+// Test fixture for CBSSolver tests
+class CBSSolverTest : public ::testing::Test
+{
+  protected:
+    void writeMap(int width, int height, const std::vector<int> &data)
+    {
+        nlohmann::json config = {
+            {"mapFile", "test_cbs_map.json"},
+            {"terrainKeys", {{"start", 0}, {"target", 8}, {"elevated", 3}, {"reachable", -1}}}};
+        writeJsonToFile("test_cbs_config.json", config);
+
+        writeGridMap("test_cbs_map.json", height, width, data);
+    }
+
+    // 32x32 map with a wall across the middle column, passable through four one cell gaps
+    void writeChokepointMap()
+    {
+        std::vector<int> data(32 * 32, -1);
+        for (int row = 0; row < 32; ++row)
+        {
+            if (row % 8 != 4)
+            {
+                data[row * 32 + 16] = 3;
+            }
+        }
+        data[0] = 0;
+        data[31] = 8;
+        writeMap(32, 32, data);
+    }
+
+    // Check that no two units share a cell or swap cells at any time step. Units stay at their
+    // target after arrival
+    void expectConflictFree(const std::vector<std::vector<Position>> &paths)
+    {
+        size_t lastTime = 0;
+        for (const auto &path : paths)
+        {
+            lastTime = std::max(lastTime, path.size());
+        }
+        auto at = [](const std::vector<Position> &path, size_t time) {
+            return time < path.size() ? path[time] : path.back();
+        };
+        for (size_t time = 0; time < lastTime; ++time)
+        {
+            for (size_t a = 0; a < paths.size(); ++a)
+            {
+                for (size_t b = a + 1; b < paths.size(); ++b)
+                {
+                    if (paths[a].empty() || paths[b].empty())
+                    {
+                        continue;
+                    }
+                    EXPECT_FALSE(at(paths[a], time) == at(paths[b], time))
+                        << "Units " << a << " and " << b << " collide at time " << time;
+                    if (time > 0)
+                    {
+                        EXPECT_FALSE(at(paths[a], time) == at(paths[b], time - 1) &&
+                                     at(paths[b], time) == at(paths[a], time - 1))
+                            << "Units " << a << " and " << b << " swap at time " << time;
+                    }
+                }
+            }
+        }
+    }
+
+    void TearDown() override
+    {
+        // Clean up files
+        remove("test_cbs_config.json");
+        remove("test_cbs_map.json");
+    }
+};
+
+// Test two units swapping ends of a corridor with a single passing bay
+TEST_F(CBSSolverTest, CorridorSwapUsesPassingBay)
+{
+    writeMap(5, 3, {0, -1, -1, -1, 8, 3, 3, -1, 3, 3, 3, 3, 3, 3, 3});
+    PathFinder pathFinder("test_cbs_config.json");
+
+    CBSSolver::Options options;
+    options.threadCount = 2;
+    CBSSolver solver(pathFinder, options);
+    CBSSolver::Result result = solver.Solve({{0, 0}, {0, 4}}, {{0, 4}, {0, 0}});
+
+    ASSERT_TRUE(result.solved);
+    ASSERT_EQ(result.paths.size(), 2u);
+    EXPECT_EQ(result.paths[0].back(), Position(0, 4));
+    EXPECT_EQ(result.paths[1].back(), Position(0, 0));
+    EXPECT_FALSE(result.resolvedConflicts.empty());
+    // Independent plans cost 8. One unit steps into the bay and back out while the other waits
+    // once for it to clear the corridor
+    EXPECT_EQ(result.cost, 11);
+    expectConflictFree(result.paths);
+}
+
+// Test that unreachable units get an empty path without failing the other units
+TEST_F(CBSSolverTest, UnreachableUnitIsSkipped)
+{
+    writeMap(4, 4, {0, -1, 3, 0, -1, -1, 3, 3, -1, -1, -1, -1, -1, -1, -1, 8});
+    PathFinder pathFinder("test_cbs_config.json");
+
+    CBSSolver solver(pathFinder);
+    CBSSolver::Result result = solver.Solve();
+
+    ASSERT_TRUE(result.solved);
+    ASSERT_EQ(result.paths.size(), 2u);
+    EXPECT_EQ(result.paths[0].back(), Position(3, 3));
+    EXPECT_TRUE(result.paths[1].empty());
+}
+
+// Test crossing traffic on an open map with parallel bounded suboptimal search
+TEST_F(CBSSolverTest, BoundedSuboptimalCrossing)
+{
+    std::vector<int> data(8 * 8, -1);
+    data[0] = 0;
+    data[63] = 8;
+    writeMap(8, 8, data);
+    PathFinder pathFinder("test_cbs_config.json");
+
+    std::vector<Position> starts, targets;
+    for (int i = 0; i < 4; ++i)
+    {
+        // Two groups crossing each other, one along rows and one along columns
+        starts.push_back({i + 2, 0});
+        targets.push_back({i + 2, 7});
+        starts.push_back({0, i + 2});
+        targets.push_back({7, i + 2});
+    }
+
+    CBSSolver::Options optimal;
+    optimal.threadCount = 4;
+    CBSSolver::Result best = CBSSolver(pathFinder, optimal).Solve(starts, targets);
+    ASSERT_TRUE(best.solved);
+    expectConflictFree(best.paths);
+
+    CBSSolver::Options bounded = optimal;
+    bounded.suboptimality = 1.5;
+    CBSSolver::Result approx = CBSSolver(pathFinder, bounded).Solve(starts, targets);
+    ASSERT_TRUE(approx.solved);
+    expectConflictFree(approx.paths);
+    EXPECT_LE(approx.cost, best.cost * 1.5);
+    EXPECT_GE(approx.cost, best.cost);
+}
+
+// Test that a suboptimality factor above 1 expands the nodes with the fewest conflicts first and
+// solves a congested instance that optimal search cannot finish within the node limit
+TEST_F(CBSSolverTest, FocalSearchSolvesWithinNodeLimit)
+{
+    std::vector<int> data(8 * 8, -1);
+    data[0] = 0;
+    data[63] = 8;
+    writeMap(8, 8, data);
+    PathFinder pathFinder("test_cbs_config.json");
+
+    const std::vector<Position> starts = {{1, 4}, {1, 7}, {4, 0}, {5, 4}, {5, 1},
+                                          {3, 1}, {2, 0}, {5, 2}, {6, 4}, {1, 1}};
+    const std::vector<Position> targets = {{7, 4}, {4, 2}, {3, 7}, {4, 1}, {0, 4},
+                                           {6, 5}, {5, 3}, {4, 6}, {2, 3}, {7, 1}};
+    // Sum of the independent shortest paths, a lower bound on the optimal cost
+    int lowerBound = 0;
+    for (size_t i = 0; i < starts.size(); ++i)
+    {
+        lowerBound += static_cast<int>(pathFinder.FindPath(starts[i], targets[i]).size()) - 1;
+    }
+
+    CBSSolver::Options options;
+    options.threadCount = 1;
+    options.batchSize = 1;
+    options.maxNodes = 300;
+    CBSSolver::Result optimal = CBSSolver(pathFinder, options).Solve(starts, targets);
+    EXPECT_FALSE(optimal.solved);
+
+    options.suboptimality = 1.5;
+    CBSSolver::Result bounded = CBSSolver(pathFinder, options).Solve(starts, targets);
+    ASSERT_TRUE(bounded.solved);
+    EXPECT_LT(bounded.generatedNodes, options.maxNodes);
+    EXPECT_LE(bounded.cost, lowerBound * 1.5);
+    expectConflictFree(bounded.paths);
+}
+
+// Test fifty units crossing the wall through its gaps within the suboptimality bound
+TEST_F(CBSSolverTest, FiftyUnitsPassChokepoints)
+{
+    writeChokepointMap();
+    PathFinder pathFinder("test_cbs_config.json");
+
+    std::vector<Position> starts, targets;
+    for (int row = 0; row < 25; ++row)
+    {
+        for (int col = 0; col < 2; ++col)
+        {
+            starts.push_back({row, col});
+            targets.push_back({(row + 12) % 25, 31 - col});
+        }
+    }
+    int lowerBound = 0;
+    for (size_t i = 0; i < starts.size(); ++i)
+    {
+        lowerBound += static_cast<int>(pathFinder.FindPath(starts[i], targets[i]).size()) - 1;
+    }
+
+    CBSSolver::Options options;
+    options.suboptimality = 1.5;
+    options.threadCount = 2;
+    options.maxNodes = 2000;
+    options.timeLimit = std::chrono::seconds(30);
+    CBSSolver::Result result = CBSSolver(pathFinder, options).Solve(starts, targets);
+    ASSERT_TRUE(result.solved);
+    EXPECT_FALSE(result.timedOut);
+    EXPECT_LE(result.cost, lowerBound * 1.5);
+    expectConflictFree(result.paths);
+}
+
+// Test that the time limit ends an optimal search of a hundred units crossing the wall
+TEST_F(CBSSolverTest, TimeLimitEndsSearch)
+{
+    writeChokepointMap();
+    PathFinder pathFinder("test_cbs_config.json");
+
+    std::vector<Position> starts, targets;
+    for (int row = 0; row < 25; ++row)
+    {
+        for (int col = 0; col < 4; ++col)
+        {
+            starts.push_back({row, col});
+            targets.push_back({(row + 12) % 25, 31 - col});
+        }
+    }
+
+    CBSSolver::Options options;
+    options.threadCount = 2;
+    options.timeLimit = std::chrono::milliseconds(200);
+    auto begin = std::chrono::steady_clock::now();
+    CBSSolver::Result result = CBSSolver(pathFinder, options).Solve(starts, targets);
+    EXPECT_FALSE(result.solved);
+    EXPECT_TRUE(result.timedOut);
+    EXPECT_LT(std::chrono::steady_clock::now() - begin, std::chrono::seconds(5));
+}
@@ -0,0 +1,203 @@
+#include "../include/ChunkedGrid.hpp"
+#include "../include/PathFinder.hpp"
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <cstdio>
+
+using namespace PathPlanner;
+using Position = PathPlanner::PathFinder::Position;
+
+// Test fixture for ChunkedGrid tests
+class ChunkedGridTest : public ::testing::Test
+{
+  protected:
+    void TearDown() override
+    {
+        // Clean up files
+        remove("test_grid.chunks");
+        remove("test_chunk_config.json");
+        remove("test_chunk_map.json");
+    }
+};
+
+// Test that cell values survive the split into chunks, including partial edge chunks
+TEST_F(ChunkedGridTest, CellAccessAcrossChunks)
+{
+    const int rows = 7, cols = 5;
+    std::vector<int> cells(rows * cols);
+    for (int i = 0; i < rows * cols; ++i)
+    {
+        cells[i] = i;
+    }
+
+    ChunkedGrid grid(rows, cols, cells, 3);
+    EXPECT_EQ(grid.Rows(), rows);
+    EXPECT_EQ(grid.Cols(), cols);
+    EXPECT_EQ(grid.ChunkCount(), 6u);
+    for (int x = 0; x < rows; ++x)
+    {
+        for (int y = 0; y < cols; ++y)
+        {
+            EXPECT_EQ(grid.At(x, y), x * cols + y);
+            EXPECT_EQ(grid[x][y], x * cols + y);
+        }
+    }
+    EXPECT_THROW(grid.At(rows, 0), std::out_of_range);
+}
+
+// Test that uniform regions share a single chunk instance
+TEST_F(ChunkedGridTest, UniformChunksAreShared)
+{
+    ChunkedGrid open(256, 256, -1, 64);
+    // 16 chunks, but only one uniform chunk of 64 x 64 ints is resident
+    EXPECT_EQ(open.ChunkCount(), 16u);
+    EXPECT_EQ(open.ResidentBytes(), 64u * 64u * sizeof(int));
+
+    std::vector<int> cells(128 * 128, 3);
+    cells[0] = -1;
+    ChunkedGrid mixed(128, 128, cells, 64);
+    // One raw chunk plus the shared all blocked chunk
+    EXPECT_EQ(mixed.ResidentBytes(), 2u * 64u * 64u * sizeof(int));
+}
+
+// Test that uniform chunks are released with the last grid using them, e.g. label grids whose
+// values never repeat across map versions
+TEST_F(ChunkedGridTest, UniformChunksAreReleased)
+{
+    const size_t before = ChunkedGrid::UniformChunkCount();
+    {
+        std::vector<ChunkedGrid> grids;
+        for (int value = 0; value < 100; ++value)
+        {
+            grids.emplace_back(64, 64, 1000000 + value, 32);
+        }
+        EXPECT_EQ(ChunkedGrid::UniformChunkCount(), before + 100);
+    }
+    EXPECT_EQ(ChunkedGrid::UniformChunkCount(), before);
+}
+
+// Test that changing a cell copies shared chunks instead of modifying them
+TEST_F(ChunkedGridTest, SetCopiesSharedChunks)
+{
+    ChunkedGrid grid(8, 8, -1, 4);
+    ChunkedGrid copy = grid;
+    const size_t sharedBytes = grid.ResidentBytes();
+
+    grid.Set(1, 2, 3);
+    grid.Set(1, 3, 3);
+    EXPECT_EQ(grid.At(1, 2), 3);
+    EXPECT_EQ(grid.At(1, 3), 3);
+    EXPECT_EQ(grid.At(0, 0), -1);
+    EXPECT_EQ(copy.At(1, 2), -1);
+    // Only the edited chunk gets its own storage
+    EXPECT_EQ(grid.ResidentBytes(), sharedBytes + 16 * sizeof(int));
+    EXPECT_THROW(grid.Set(8, 0, 3), std::out_of_range);
+}
+
+// Test writing a chunk file and lazily loading it back under a memory cap
+TEST_F(ChunkedGridTest, LazyChunkFileWithEviction)
+{
+    const int size = 32;
+    std::vector<int> cells(size * size, -1);
+    for (int i = 0; i < size; ++i)
+    {
+        // Diagonal makes every chunk on it non uniform
+        cells[i * size + i] = 3;
+    }
+    ChunkedGrid grid(size, size, cells, 8);
+    grid.WriteChunkFile("test_grid.chunks", {{0, 1, 2}});
+
+    std::vector<ChunkedGrid::Marker> markers;
+    const size_t chunkBytes = 8 * 8 * sizeof(int);
+    ChunkedGrid lazy = ChunkedGrid::OpenChunkFile("test_grid.chunks", 2 * chunkBytes, &markers);
+    ASSERT_EQ(markers.size(), 1u);
+    EXPECT_EQ(markers[0].x, 1);
+    EXPECT_EQ(markers[0].y, 2);
+
+    // Only the shared uniform chunk is resident before any raw chunk is touched
+    EXPECT_EQ(lazy.ResidentBytes(), chunkBytes);
+    for (int x = 0; x < size; ++x)
+    {
+        for (int y = 0; y < size; ++y)
+        {
+            EXPECT_EQ(lazy.At(x, y), cells[x * size + y]);
+        }
+    }
+    // Four raw diagonal chunks were decoded, at most two of them stay resident
+    EXPECT_LE(lazy.ResidentBytes(), 3 * chunkBytes);
+}
+
+// Test that a PathFinder can be constructed from an exported chunk file
+TEST_F(ChunkedGridTest, PathFinderFromChunkFile)
+{
+    nlohmann::json config = {
+        {"mapFile", "test_chunk_map.json"},
+        {"chunkSize", 2},
+        {"terrainKeys", {{"start", 0}, {"target", 8}, {"elevated", 3}, {"reachable", -1}}}};
+    writeJsonToFile("test_chunk_config.json", config);
+
+    writeGridMap("test_chunk_map.json", 4, 4,
+                 {0, -1, 0, -1, -1, -1, -1, -1, -1, 8, -1, -1, 3, -1, 8, 3});
+
+    PathFinder source("test_chunk_config.json");
+    source.ExportChunkFile("test_grid.chunks");
+
+    config["mapFile"] = "test_grid.chunks";
+    config["chunkMemoryLimit"] = 16;
+    writeJsonToFile("test_chunk_config.json", config);
+    PathFinder chunked("test_chunk_config.json");
+
+    EXPECT_EQ(chunked.GetStartPosition(0), source.GetStartPosition(0));
+    EXPECT_EQ(chunked.GetStartPosition(1), source.GetStartPosition(1));
+    EXPECT_EQ(chunked.GetTargetPosition(0), source.GetTargetPosition(0));
+    EXPECT_EQ(chunked.GetTargetPosition(1), source.GetTargetPosition(1));
+    for (int x = 0; x < 4; ++x)
+    {
+        for (int y = 0; y < 4; ++y)
+        {
+            EXPECT_EQ(chunked.GetMap().At(x, y), source.GetMap().At(x, y));
+        }
+    }
+    EXPECT_NO_THROW(chunked.FindPaths());
+}
+
+// Test that short queries on a chunk file map only decode the chunks around them
+TEST_F(ChunkedGridTest, ShortQueriesStayWithinChunkLimit)
+{
+    constexpr int Size = 256;
+    constexpr int ChunkSize = 16;
+    constexpr size_t ChunkBytes = ChunkSize * ChunkSize * sizeof(int);
+    nlohmann::json config = {
+        {"mapFile", "test_chunk_map.json"},
+        {"headless", true},
+        {"chunkSize", ChunkSize},
+        {"terrainKeys", {{"start", 0}, {"target", 8}, {"elevated", 3}, {"reachable", -1}}}};
+    writeJsonToFile("test_chunk_config.json", config);
+
+    std::vector<int> data(Size * Size, -1);
+    data[0] = 0;
+    data[Size * Size - 1] = 8;
+    data[2 * Size + 1] = 3;
+    writeGridMap("test_chunk_map.json", Size, Size, data);
+    PathFinder("test_chunk_config.json").ExportChunkFile("test_grid.chunks");
+
+    config["mapFile"] = "test_grid.chunks";
+    config["chunkMemoryLimit"] = 4 * ChunkBytes;
+    writeJsonToFile("test_chunk_config.json", config);
+    PathFinder chunked("test_chunk_config.json");
+
+    EXPECT_EQ(chunked.FindPath({0, 0}, {5, 3}).size(), 9u);
+    EXPECT_TRUE(chunked.AreConnected({0, 0}, {5, 3}));
+    PathFinder::QueryOptions options;
+    options.unitSize = 2;
+    // The footprint has to pass the blocked cell on its right
+    EXPECT_EQ(chunked.FindPath({0, 0}, {4, 0}, options).size(), 9u);
+    EXPECT_EQ(chunked.GetClearance({1, 0}), 1);
+    EXPECT_LE(chunked.GetMap().ResidentBytes(), 5 * ChunkBytes);
+    // Nothing covering the whole map was built on the side
+    EXPECT_EQ(chunked.GetMapVersion()->componentLabels, nullptr);
+    EXPECT_EQ(chunked.GetMapVersion()->clearance, nullptr);
+}
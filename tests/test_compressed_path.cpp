@@ -0,0 +1,119 @@
+#include "../include/CompressedPath.hpp"
+#include "../include/PathFinder.hpp"
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+using namespace PathPlanner;
+using Position = PathPlanner::PathFinder::Position;
+
+// Test fixture for compressed path tests
+class CompressedPathTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // 4x4 map with a wall the paths have to turn around
+        nlohmann::json config = {
+            {"mapFile", "test_compressed_map.json"},
+            {"headless", true},
+            {"terrainKeys", {{"start", 0}, {"target", 8}, {"elevated", 3}, {"reachable", -1}}}};
+        writeJsonToFile("test_compressed_config.json", config);
+
+        writeGridMap("test_compressed_map.json", 4, 4,
+                     {0, -1, -1, -1, 3, 3, 3, -1, -1, -1, -1, -1, -1, 3, 3, 8});
+    }
+
+    void TearDown() override
+    {
+        // Clean up files
+        remove("test_compressed_config.json");
+        remove("test_compressed_map.json");
+    }
+};
+
+// Test that runs, waypoints and lazily expanded cells match the original path
+TEST_F(CompressedPathTest, EncodesRuns)
+{
+    const std::vector<Position> cells = {{0, 0}, {0, 1}, {0, 2}, {1, 2}, {2, 2}, {2, 1}};
+    CompressedPath path(cells);
+    EXPECT_EQ(path.Size(), cells.size());
+    ASSERT_EQ(path.RunCount(), 3u);
+    EXPECT_EQ(path.GetRun(0).direction, CompressedPath::Direction::Right);
+    EXPECT_EQ(path.GetRun(0).length, 2u);
+    EXPECT_EQ(path.GetRun(1).direction, CompressedPath::Direction::Down);
+    EXPECT_EQ(path.GetRun(2).direction, CompressedPath::Direction::Left);
+    EXPECT_EQ(path.Target(), Position(2, 1));
+
+    const std::vector<Position> waypoints = {{0, 0}, {0, 2}, {2, 2}, {2, 1}};
+    EXPECT_EQ(path.Waypoints(), waypoints);
+    EXPECT_EQ(path.Expand(), cells);
+
+    // Single cell and empty paths
+    EXPECT_EQ(CompressedPath({{3, 3}}).Expand(), std::vector<Position>({{3, 3}}));
+    EXPECT_TRUE(CompressedPath().Empty());
+    EXPECT_TRUE(CompressedPath().Expand().empty());
+
+    // Diagonal moves are encoded, cells that are not neighbors are rejected
+    EXPECT_EQ(CompressedPath({{0, 0}, {1, 1}, {2, 2}, {1, 3}}).RunCount(), 2u);
+    EXPECT_THROW(CompressedPath({{0, 0}, {2, 0}}), std::invalid_argument);
+}
+
+// Test that long straight paths take a few bytes instead of one position per cell
+TEST_F(CompressedPathTest, StraightPathsAreSmall)
+{
+    std::vector<Position> cells;
+    for (int y = 0; y < 1000; ++y)
+    {
+        cells.push_back({0, y});
+    }
+    CompressedPath path(cells);
+    EXPECT_EQ(path.RunCount(), 1u);
+    EXPECT_LT(path.MemoryUsage() * 100, cells.size() * sizeof(Position));
+}
+
+// Test that paths built from a parent chain equal paths compressed from their cells
+TEST_F(CompressedPathTest, FromParentChain)
+{
+    const std::vector<Position> cells = {{1, 1}, {1, 2}, {1, 3}, {0, 3}};
+    std::vector<PathFinder::Node> nodes;
+    nodes.reserve(cells.size());
+    for (size_t i = 0; i < cells.size(); ++i)
+    {
+        nodes.emplace_back(cells[i], 0, 0, i == 0 ? nullptr : &nodes[i - 1]);
+    }
+    EXPECT_EQ(CompressedPath::FromParentChain(&nodes.back()), CompressedPath(cells));
+    EXPECT_EQ(CompressedPath::FromParentChain(&nodes.back()).Expand(), cells);
+    EXPECT_TRUE(CompressedPath::FromParentChain<PathFinder::Node>(nullptr).Empty());
+}
+
+// Test that compressed queries and FindPaths output expand to the plain paths
+TEST_F(CompressedPathTest, PathFinderOutput)
+{
+    PathFinder pathFinder("test_compressed_config.json");
+    const std::vector<Position> path = pathFinder.FindPath({0, 0}, {3, 3});
+    ASSERT_FALSE(path.empty());
+    EXPECT_EQ(pathFinder.FindCompressedPath({0, 0}, {3, 3}).Expand(), path);
+    EXPECT_TRUE(pathFinder.FindCompressedPath({0, 0}, {1, 1}).Empty());
+
+    pathFinder.FindPaths();
+    ASSERT_EQ(pathFinder.GetPaths().size(), 1u);
+    const std::vector<Position> solved = pathFinder.GetPaths()[0];
+
+    nlohmann::json config = {
+        {"mapFile", "test_compressed_map.json"},
+        {"headless", true},
+        {"compressPaths", true},
+        {"terrainKeys", {{"start", 0}, {"target", 8}, {"elevated", 3}, {"reachable", -1}}}};
+    writeJsonToFile("test_compressed_config.json", config);
+    PathFinder compressing("test_compressed_config.json");
+    compressing.FindPaths();
+    EXPECT_TRUE(compressing.GetPaths().empty());
+    ASSERT_EQ(compressing.GetCompressedPaths().size(), 1u);
+    EXPECT_EQ(compressing.GetCompressedPaths()[0].Expand(), solved);
+}
@@ -0,0 +1,136 @@
+#include "../include/ContractionHierarchy.hpp"
+#include "../include/PathFinder.hpp"
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+
+using namespace PathPlanner;
+using Position = PathPlanner::PathFinder::Position;
+
+// Test fixture for contraction hierarchy tests
+class ContractionHierarchyTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        m_config = {
+            {"mapFile", "test_ch_map.json"},
+            {"headless", true},
+            {"contractionHierarchy", true},
+            {"terrainKeys", {{"start", 0}, {"target", 8}, {"elevated", 3}, {"reachable", -1}}}};
+        writeJsonToFile("test_ch_config.json", m_config);
+
+        // Random obstacles with a unit in opposite corners
+        std::mt19937 random(7);
+        std::vector<int> data(Size * Size);
+        for (auto &cell : data)
+        {
+            cell = random() % 4 == 0 ? 3 : -1;
+        }
+        data[0] = 0;
+        data[1] = data[Size] = -1;
+        data.back() = 8;
+        writeGridMap("test_ch_map.json", Size, Size, data);
+    }
+
+    void TearDown() override
+    {
+        // Clean up files
+        remove("test_ch_config.json");
+        remove("test_ch_map.json");
+        remove("test_ch_snapshot.bin");
+    }
+
+    // Check that a path only makes single steps over traversable cells
+    static void expectValidPath(const PathFinder &pathFinder, const std::vector<Position> &path)
+    {
+        for (size_t i = 0; i < path.size(); ++i)
+        {
+            EXPECT_TRUE(pathFinder.IsTraversable(path[i]));
+            if (i > 0)
+            {
+                EXPECT_EQ(std::abs(path[i].x - path[i - 1].x) + std::abs(path[i].y - path[i - 1].y),
+                          1);
+            }
+        }
+    }
+
+    static constexpr int Size = 24;
+    nlohmann::json m_config;
+};
+
+// Test that hierarchy queries match plain A* distances and unpack into valid paths
+TEST_F(ContractionHierarchyTest, MatchesAStar)
+{
+    m_config["contractionHierarchy"] = false;
+    writeJsonToFile("test_ch_config.json", m_config);
+    PathFinder pathFinder("test_ch_config.json");
+    ContractionHierarchy hierarchy(pathFinder);
+    EXPECT_GT(hierarchy.ShortcutCount(), 0u);
+
+    std::mt19937 random(11);
+    int connected = 0;
+    for (int query = 0; query < 300; ++query)
+    {
+        Position start(random() % Size, random() % Size);
+        Position target(random() % Size, random() % Size);
+        std::vector<Position> expected = pathFinder.FindPath(start, target);
+        std::vector<Position> path = hierarchy.FindPath(start, target);
+        ASSERT_EQ(path.size(), expected.size());
+        EXPECT_EQ(hierarchy.Distance(start, target), static_cast<int>(expected.size()) - 1);
+        if (!path.empty())
+        {
+            ++connected;
+            EXPECT_EQ(path.front(), start);
+            EXPECT_EQ(path.back(), target);
+            expectValidPath(pathFinder, path);
+        }
+    }
+    EXPECT_GT(connected, 100);
+}
+
+// Test that a serialized hierarchy answers the same queries
+TEST_F(ContractionHierarchyTest, SerializeRoundTrip)
+{
+    PathFinder pathFinder("test_ch_config.json");
+    ASSERT_TRUE(pathFinder.HasContractionHierarchy());
+    ContractionHierarchy hierarchy(pathFinder);
+
+    std::stringstream stream;
+    hierarchy.Serialize(stream);
+    ContractionHierarchy restored = ContractionHierarchy::Deserialize(stream);
+    EXPECT_EQ(restored.NodeCount(), hierarchy.NodeCount());
+    EXPECT_EQ(restored.ShortcutCount(), hierarchy.ShortcutCount());
+    for (int y = 0; y < Size; ++y)
+    {
+        EXPECT_EQ(restored.FindPath({0, 0}, {Size - 1, y}), hierarchy.FindPath({0, 0}, {Size - 1, y}));
+    }
+
+    std::stringstream truncated(stream.str().substr(0, 20));
+    EXPECT_THROW(ContractionHierarchy::Deserialize(truncated), std::runtime_error);
+}
+
+// Test that the hierarchy is stored in snapshots and dropped when the terrain changes
+TEST_F(ContractionHierarchyTest, PathFinderIntegration)
+{
+    m_config["snapshotFile"] = "test_ch_snapshot.bin";
+    m_config["shareMap"] = false;
+    writeJsonToFile("test_ch_config.json", m_config);
+    PathFinder cold("test_ch_config.json");
+    PathFinder warm("test_ch_config.json");
+    ASSERT_TRUE(warm.IsLoadedFromSnapshot());
+    ASSERT_TRUE(warm.HasContractionHierarchy());
+    EXPECT_EQ(warm.FindPath({0, 0}, {Size - 1, Size - 1}),
+              cold.FindPath({0, 0}, {Size - 1, Size - 1}));
+
+    warm.SetTerrain({0, 1}, 3);
+    warm.SetTerrain({1, 0}, 3);
+    EXPECT_FALSE(warm.HasContractionHierarchy());
+    EXPECT_TRUE(warm.FindPath({0, 0}, {Size - 1, Size - 1}).empty());
+}
@@ -0,0 +1,179 @@
+#include "../include/FrontierSearch.hpp"
+#include "../include/PathFinder.hpp"
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+using namespace PathPlanner;
+using Position = PathPlanner::PathFinder::Position;
+
+// Test fixture for memory bounded search tests
+class FrontierSearchTest : public ::testing::Test
+{
+  protected:
+    // 32x32 map with walls that force the path to wind through the map
+    void SetUp() override
+    {
+        nlohmann::json config = {
+            {"mapFile", "test_frontier_map.json"},
+            {"headless", true},
+            {"terrainKeys", {{"start", 0}, {"target", 8}, {"elevated", 3}, {"reachable", -1}}}};
+        writeJsonToFile("test_frontier_config.json", config);
+
+        std::vector<int> data(Size * Size, -1);
+        for (int row = 4; row < Size; row += 8)
+        {
+            const bool gapLeft = (row / 8) % 2 == 0;
+            for (int col = 0; col < Size; ++col)
+            {
+                if (gapLeft ? col > 1 : col < Size - 2)
+                {
+                    data[row * Size + col] = 3;
+                }
+            }
+        }
+        data[31 * Size + 30] = 3;
+        data[30 * Size + 31] = 3;
+
+        writeGridMap("test_frontier_map.json", Size, Size, data);
+    }
+
+    // Consecutive cells are neighbors on traversable ground
+    void expectValidPath(const PathFinder &pathFinder, const std::vector<Position> &path,
+                         const Position &start, const Position &target)
+    {
+        ASSERT_FALSE(path.empty());
+        EXPECT_EQ(path.front(), start);
+        EXPECT_EQ(path.back(), target);
+        for (size_t i = 0; i < path.size(); ++i)
+        {
+            EXPECT_TRUE(pathFinder.IsTraversable(path[i]));
+            if (i > 0)
+            {
+                EXPECT_EQ(std::abs(path[i].x - path[i - 1].x) + std::abs(path[i].y - path[i - 1].y),
+                          1);
+            }
+        }
+    }
+
+    void TearDown() override
+    {
+        // Clean up files
+        remove("test_frontier_config.json");
+        remove("test_frontier_map.json");
+    }
+
+    static constexpr int Size = 32;
+};
+
+// Test that frontier search finds paths as short as A* while holding fewer cells than it explores
+TEST_F(FrontierSearchTest, MatchesAStar)
+{
+    PathFinder pathFinder("test_frontier_config.json");
+    FrontierSearch search(pathFinder);
+    const Position start(0, 31);
+    const Position target(30, 0);
+
+    FrontierSearch::Result result = search.FindPath(start, target);
+    expectValidPath(pathFinder, result.path, start, target);
+    EXPECT_EQ(result.path.size(), pathFinder.FindPath(start, target).size());
+    EXPECT_TRUE(result.reachesTarget);
+    EXPECT_TRUE(result.optimal);
+    EXPECT_LT(result.peakNodes, result.expandedNodes);
+    EXPECT_EQ(result.peakMemory, result.peakNodes * FrontierSearch::NodeBytes);
+
+    EXPECT_EQ(search.FindPath(start, start).path, std::vector<Position>({start}));
+    EXPECT_TRUE(search.FindPath(start, {31, 31}).path.empty());
+    EXPECT_TRUE(search.FindPath(start, {4, 10}).path.empty());
+}
+
+// Test that a memory limit caps the search state, and that a query losing every way to the target
+// still returns a path towards it
+TEST_F(FrontierSearchTest, RespectsMemoryLimit)
+{
+    PathFinder pathFinder("test_frontier_config.json");
+    FrontierSearch::Options options;
+    options.memoryLimit = 8 * FrontierSearch::NodeBytes;
+    FrontierSearch search(pathFinder, options);
+
+    // Open ground fits the limit
+    const Position start(0, 0);
+    FrontierSearch::Result result = search.FindPath(start, {3, 25});
+    expectValidPath(pathFinder, result.path, start, {3, 25});
+    EXPECT_TRUE(result.reachesTarget);
+    EXPECT_LE(result.peakNodes, 8u);
+    EXPECT_LE(result.peakMemory, options.memoryLimit);
+
+    // The winding path does not, the unit gets a path to the closest cell reached
+    result = search.FindPath(start, {30, 20});
+    ASSERT_FALSE(result.path.empty());
+    expectValidPath(pathFinder, result.path, start, result.path.back());
+    EXPECT_FALSE(result.reachesTarget);
+    EXPECT_FALSE(result.optimal);
+    EXPECT_LT(std::abs(result.path.back().x - 30) + std::abs(result.path.back().y - 20), 50);
+    EXPECT_LE(result.peakMemory, options.memoryLimit);
+
+    options.memoryLimit = FrontierSearch::NodeBytes;
+    EXPECT_THROW(FrontierSearch(pathFinder, options), std::invalid_argument);
+}
+
+// Test that queries on chunk file maps, which have no component labels, never build any and that
+// blocked off targets are still reported without a path
+TEST_F(FrontierSearchTest, ChunkFileMap)
+{
+    PathFinder("test_frontier_config.json").ExportChunkFile("test_frontier.chunks");
+    nlohmann::json config = {
+        {"mapFile", "test_frontier.chunks"},
+        {"headless", true},
+        {"terrainKeys", {{"start", 0}, {"target", 8}, {"elevated", 3}, {"reachable", -1}}}};
+    writeJsonToFile("test_frontier_config.json", config);
+    PathFinder pathFinder("test_frontier_config.json");
+    FrontierSearch::Options options;
+    options.memoryLimit = 64 * FrontierSearch::NodeBytes;
+    FrontierSearch search(pathFinder, options);
+
+    FrontierSearch::Result result = search.FindPath({0, 0}, {3, 25});
+    expectValidPath(pathFinder, result.path, {0, 0}, {3, 25});
+    result = search.FindPath({0, 0}, {31, 31});
+    EXPECT_FALSE(result.reachesTarget);
+    EXPECT_EQ(pathFinder.GetMapVersion()->componentLabels, nullptr);
+    remove("test_frontier.chunks");
+}
+
+// Test that path recovery splits at half the path cost. On a serpentine maze the path is far
+// longer than the distance between its ends, and splitting at half the distance would search the
+// maze again for every few cells of the path
+TEST_F(FrontierSearchTest, SerpentineMazeRecoversInHalves)
+{
+    constexpr int MazeSize = 64;
+    std::vector<int> data(MazeSize * MazeSize, -1);
+    for (int row = 1; row < MazeSize; row += 2)
+    {
+        for (int col = 0; col < MazeSize; ++col)
+        {
+            data[row * MazeSize + col] = 3;
+        }
+        data[row * MazeSize + (row % 4 == 1 ? MazeSize - 1 : 0)] = -1;
+    }
+    writeGridMap("test_frontier_map.json", MazeSize, MazeSize, data);
+    PathFinder pathFinder("test_frontier_config.json");
+    FrontierSearch search(pathFinder);
+    const Position start(0, 0);
+    const Position target(MazeSize - 2, 0);
+
+    FrontierSearch::Result result = search.FindPath(start, target);
+    expectValidPath(pathFinder, result.path, start, target);
+    const size_t cost = result.path.size() - 1;
+    EXPECT_EQ(result.path.size(), pathFinder.FindPath(start, target).size());
+    EXPECT_GT(cost, 2000u);
+    // Every level of the recursion covers the path about once and there are log2(cost) levels.
+    // Splitting at half the distance expanded about 120,000 cells here
+    EXPECT_LT(result.expandedNodes, 2 * cost * std::log2(cost));
+}
@@ -0,0 +1,102 @@
+#include "../include/MapRenderer.hpp"
+#include "../include/PathFinder.hpp"
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+using namespace PathPlanner;
+using Position = PathPlanner::PathFinder::Position;
+
+// Test fixture for map renderer tests
+class MapRendererTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // 2x3 map, elevated cell in the middle of the bottom row
+        m_grid = ChunkedGrid(2, 3, {-1, -1, -1, -1, 3, -1});
+    }
+
+    void TearDown() override
+    {
+        // Clean up files
+        remove("test_renderer_config.json");
+        remove("test_renderer_map.json");
+        remove("test_renderer.ppm");
+    }
+
+    ChunkedGrid m_grid;
+    MapRenderer::Legend m_legend{3, -1};
+};
+
+// Test that terrain, markers and paths are drawn with their symbols
+TEST_F(MapRendererTest, RendersSymbols)
+{
+    MapRenderer renderer(m_grid, m_legend);
+    renderer.SetMarkers({{1, 0}}, {{1, 2}});
+    renderer.SetPaths({{{1, 0}, {0, 0}, {0, 1}, {0, 2}, {1, 2}}});
+
+    const std::string path = "\033[31mP \033[0m";
+    EXPECT_EQ(renderer.RenderAnsi(), path + path + path + "\nS # T \n");
+}
+
+// Test that lower unit indices win shared cells, and that the last path wins shared path cells
+TEST_F(MapRendererTest, OverlayPrecedence)
+{
+    MapRenderer renderer(m_grid, m_legend);
+    renderer.SetMarkers({{0, 1}, {0, 0}}, {{0, 0}, {0, 1}});
+    renderer.SetPaths({{{1, 0}, {1, 2}}, {{1, 2}}});
+
+    EXPECT_EQ(renderer.RenderAnsi(), "T S . \n\033[31mP \033[0m# \033[32mP \033[0m\n");
+}
+
+// Test that the PPM export has the expected header and pixel count
+TEST_F(MapRendererTest, WritesPPM)
+{
+    MapRenderer renderer(m_grid, m_legend);
+    renderer.SetMarkers({{1, 0}}, {{1, 2}});
+    renderer.WritePPM("test_renderer.ppm", 2);
+
+    std::ifstream file("test_renderer.ppm", std::ios::binary);
+    std::string magic;
+    int width = 0, height = 0, maxValue = 0;
+    file >> magic >> width >> height >> maxValue;
+    file.get();
+    EXPECT_EQ(magic, "P6");
+    EXPECT_EQ(width, 6);
+    EXPECT_EQ(height, 4);
+    EXPECT_EQ(maxValue, 255);
+
+    std::vector<char> pixels((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(pixels.size(), static_cast<size_t>(width * height * 3));
+    EXPECT_THROW(renderer.WritePPM("test_renderer.ppm", 0), std::invalid_argument);
+}
+
+// Test that a headless PathFinder keeps its paths and writes the configured image
+TEST_F(MapRendererTest, HeadlessPathFinderExportsImage)
+{
+    nlohmann::json config = {
+        {"mapFile", "test_renderer_map.json"},
+        {"headless", true},
+        {"imageFile", "test_renderer.ppm"},
+        {"terrainKeys", {{"start", 0}, {"target", 8}, {"elevated", 3}, {"reachable", -1}}}};
+    writeJsonToFile("test_renderer_config.json", config);
+    writeGridMap("test_renderer_map.json", 2, 2, {0, -1, 3, 8});
+
+    PathFinder pathFinder("test_renderer_config.json");
+    testing::internal::CaptureStdout();
+    pathFinder.FindPaths();
+    std::string output = testing::internal::GetCapturedStdout();
+    EXPECT_EQ(output.find("Path for unit"), std::string::npos);
+
+    ASSERT_EQ(pathFinder.GetPaths().size(), 1u);
+    EXPECT_EQ(pathFinder.GetPaths()[0].size(), 3u);
+    std::ifstream image("test_renderer.ppm", std::ios::binary);
+    EXPECT_TRUE(image.is_open());
+}
@@ -0,0 +1,143 @@
+#include "../include/PathCache.hpp"
+#include "../include/PathFinder.hpp"
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace PathPlanner;
+using Position = PathPlanner::PathFinder::Position;
+
+// Test fixture for path reuse tests
+class PathCacheTest : public ::testing::Test
+{
+  protected:
+    // 40x40 map with random obstacles, a free block of squad cells in the top left corner and a
+    // free target area in the bottom right corner
+    void SetUp() override
+    {
+        nlohmann::json config = {
+            {"mapFile", "test_path_cache_map.json"},
+            {"headless", true},
+            {"terrainKeys", {{"start", 0}, {"target", 8}, {"elevated", 3}, {"reachable", -1}}}};
+        writeJsonToFile("test_path_cache_config.json", config);
+
+        std::mt19937 random(3);
+        std::vector<int> data(Size * Size);
+        for (int row = 0; row < Size; ++row)
+        {
+            for (int col = 0; col < Size; ++col)
+            {
+                const bool open = (row < 6 && col < 9) || (row > Size - 4 && col > Size - 4);
+                data[row * Size + col] = !open && random() % 5 == 0 ? 3 : -1;
+            }
+        }
+
+        writeGridMap("test_path_cache_map.json", Size, Size, data);
+    }
+
+    void TearDown() override
+    {
+        // Clean up files
+        remove("test_path_cache_config.json");
+        remove("test_path_cache_map.json");
+    }
+
+    // Cost of a path in the units of the search, checking that its moves are single steps
+    int pathCost(const std::vector<Position> &path, bool allowDiagonal)
+    {
+        int cost = 0;
+        for (size_t i = 1; i < path.size(); ++i)
+        {
+            const int dx = std::abs(path[i].x - path[i - 1].x);
+            const int dy = std::abs(path[i].y - path[i - 1].y);
+            EXPECT_TRUE(dx <= 1 && dy <= 1 && dx + dy > 0);
+            if (!allowDiagonal)
+            {
+                cost += dx + dy;
+            }
+            else
+            {
+                cost += dx + dy == 2 ? PathFinder::OctileDiagonalCost
+                                     : PathFinder::OctileStraightCost;
+            }
+        }
+        return cost;
+    }
+
+    static constexpr int Size = 40;
+};
+
+// Test that a squad sent to one target reuses the path of the first unit and still gets shortest
+// paths, with and without diagonal moves
+TEST_F(PathCacheTest, SplicesSquadPaths)
+{
+    PathFinder pathFinder("test_path_cache_config.json");
+    const Position target(Size - 2, Size - 2);
+    for (bool allowDiagonal : {false, true})
+    {
+        PathCache cache(pathFinder);
+        PathFinder::QueryOptions options;
+        options.allowDiagonal = allowDiagonal;
+        int spliced = 0;
+        for (int row = 0; row < 5; ++row)
+        {
+            for (int col = 0; col < 8; ++col)
+            {
+                const Position start(row, col);
+                PathCache::Result result = cache.FindPath(start, target, options);
+                const std::vector<Position> expected = pathFinder.FindPath(start, target, options);
+                ASSERT_FALSE(result.path.empty());
+                EXPECT_EQ(result.path.front(), start);
+                EXPECT_EQ(result.path.back(), target);
+                EXPECT_EQ(pathCost(result.path, allowDiagonal),
+                          pathCost(expected, allowDiagonal));
+                for (const auto &cell : result.path)
+                {
+                    EXPECT_TRUE(pathFinder.IsTraversable(cell));
+                }
+                spliced += result.spliced;
+            }
+        }
+        // Only the first unit searches the whole way
+        EXPECT_EQ(spliced, 39);
+    }
+}
+
+// Test that edits and limits drop cached paths
+TEST_F(PathCacheTest, DropsStalePaths)
+{
+    PathFinder pathFinder("test_path_cache_config.json");
+    PathCache::Options options;
+    options.maxTargets = 1;
+    PathCache cache(pathFinder, options);
+    const Position target(Size - 2, Size - 2);
+
+    PathCache::Result first = cache.FindPath({0, 0}, target);
+    ASSERT_FALSE(first.path.empty());
+    EXPECT_FALSE(first.spliced);
+    EXPECT_EQ(cache.GetCachedCells(), first.path.size());
+    EXPECT_TRUE(cache.FindPath({1, 0}, target).spliced);
+
+    // Blocking a cell of the cached path makes its routes stale
+    pathFinder.SetTerrain(first.path[first.path.size() / 2], 3);
+    PathCache::Result edited = cache.FindPath({1, 0}, target);
+    EXPECT_FALSE(edited.spliced);
+    EXPECT_EQ(edited.path.size(), pathFinder.FindPath({1, 0}, target).size());
+
+    // Only the most recent target is kept
+    PathCache::Result other = cache.FindPath({0, 0}, {Size - 1, Size - 1});
+    EXPECT_EQ(cache.GetCachedCells(), other.path.size());
+    EXPECT_FALSE(cache.FindPath({1, 0}, target).spliced);
+
+    cache.Clear();
+    EXPECT_EQ(cache.GetCachedCells(), 0u);
+    options.maxTargets = 0;
+    EXPECT_THROW(PathCache(pathFinder, options), std::invalid_argument);
+}
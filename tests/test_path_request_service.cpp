@@ -0,0 +1,128 @@
+#include "../include/PathFinder.hpp"
+#include "../include/PathRequestService.hpp"
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <cstdio>
+
+using namespace PathPlanner;
+using Position = PathPlanner::PathFinder::Position;
+using Service = PathPlanner::PathRequestService;
+
+// Test fixture for PathRequestService tests, uses an open 64 x 64 map
+class PathRequestServiceTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        nlohmann::json config = {
+            {"mapFile", "test_service_map.json"},
+            {"terrainKeys", {{"start", 0}, {"target", 8}, {"elevated", 3}, {"reachable", -1}}}};
+        writeJsonToFile("test_service_config.json", config);
+
+        std::vector<int> data(64 * 64, -1);
+        data.front() = 0;
+        data.back() = 8;
+        writeGridMap("test_service_map.json", 64, 64, data);
+    }
+
+    void TearDown() override
+    {
+        // Clean up files
+        remove("test_service_config.json");
+        remove("test_service_map.json");
+    }
+};
+
+// Test that submitted requests complete with a path
+TEST_F(PathRequestServiceTest, SubmitCompletes)
+{
+    PathFinder pathFinder("test_service_config.json");
+    Service::Options options;
+    options.threadCount = 2;
+    Service service(pathFinder, options);
+
+    std::vector<Service::Handle> handles;
+    for (int i = 0; i < 8; ++i)
+    {
+        handles.push_back(service.Submit({{0, i}, {63, 63 - i}, Service::Priority::Normal, {}}));
+    }
+    for (int i = 0; i < 8; ++i)
+    {
+        const Service::Response &response = handles[i].result.get();
+        ASSERT_EQ(response.status, Service::Status::Completed);
+        EXPECT_EQ(response.path.front(), Position(0, i));
+        EXPECT_EQ(response.path.back(), Position(63, 63 - i));
+        EXPECT_EQ(response.path.size(), 127u - 2 * i);
+    }
+    EXPECT_EQ(service.GetPendingCount(), 0u);
+    EXPECT_FALSE(service.Cancel(handles[0].id));
+}
+
+// Test that requests whose deadline already passed never run a search
+TEST_F(PathRequestServiceTest, ExpiredRequestIsDropped)
+{
+    PathFinder pathFinder("test_service_config.json");
+    Service service(pathFinder);
+
+    Service::Request request{{0, 0}, {63, 63}, Service::Priority::High,
+                             Service::Clock::now() - std::chrono::milliseconds(1)};
+    const Service::Response &response = service.Submit(request).result.get();
+    EXPECT_EQ(response.status, Service::Status::Expired);
+    EXPECT_TRUE(response.path.empty());
+}
+
+// Test cancelling requests queued behind a busy worker
+TEST_F(PathRequestServiceTest, CancelQueuedRequests)
+{
+    PathFinder pathFinder("test_service_config.json");
+    Service::Options options;
+    options.threadCount = 1;
+    Service service(pathFinder, options);
+
+    std::vector<Service::Handle> handles;
+    for (int i = 0; i < 32; ++i)
+    {
+        handles.push_back(service.Submit({{0, 0}, {63, 63}, Service::Priority::Low, {}}));
+    }
+    size_t cancelled = 0;
+    for (const auto &handle : handles)
+    {
+        if (service.Cancel(handle.id))
+        {
+            ++cancelled;
+            EXPECT_EQ(handle.result.get().status, Service::Status::Cancelled);
+        }
+        else
+        {
+            EXPECT_EQ(handle.result.get().status, Service::Status::Completed);
+        }
+    }
+    // The single worker cannot have finished every search before the cancellations
+    EXPECT_GT(cancelled, 0u);
+    EXPECT_EQ(service.GetPendingCount(), 0u);
+}
+
+// Test that requests beyond the queue limit are rejected
+TEST_F(PathRequestServiceTest, QueueLimitRejects)
+{
+    PathFinder pathFinder("test_service_config.json");
+    Service::Options options;
+    options.threadCount = 1;
+    options.maxPending = 1;
+    Service service(pathFinder, options);
+
+    std::vector<Service::Handle> handles;
+    for (int i = 0; i < 4; ++i)
+    {
+        handles.push_back(service.Submit({{0, 0}, {63, 63}, Service::Priority::Normal, {}}));
+    }
+    size_t rejected = 0;
+    for (const auto &handle : handles)
+    {
+        rejected += handle.result.get().status == Service::Status::Rejected;
+    }
+    EXPECT_GE(rejected, 1u);
+}
@@ -0,0 +1,136 @@
+#include "../include/PathClient.hpp"
+#include "../include/PathFinder.hpp"
+#include "../include/PathServer.hpp"
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <cstdio>
+#include <thread>
+
+using namespace PathPlanner;
+using Position = PathPlanner::PathFinder::Position;
+
+// Test fixture for PathServer tests, serves a 4 x 4 map with a gap in an obstacle row
+class PathServerTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        nlohmann::json config = {
+            {"mapFile", "test_server_map.json"},
+            {"terrainKeys", {{"start", 0}, {"target", 8}, {"elevated", 3}, {"reachable", -1}}}};
+        writeJsonToFile("test_server_config.json", config);
+
+        writeGridMap("test_server_map.json", 4, 4,
+                     {0, -1, -1, -1, 3, 3, 3, -1, -1, -1, -1, -1, -1, 3, 3, 8});
+
+        m_server = std::make_unique<PathServer>(
+            std::vector<std::string>{"test_server_config.json"}, SocketPath, 2);
+        m_serverThread = std::thread([this]() { m_server->Run(); });
+    }
+
+    void TearDown() override
+    {
+        m_server->Stop();
+        m_serverThread.join();
+        m_server.reset();
+        // Clean up files
+        remove("test_server_config.json");
+        remove("test_server_map.json");
+    }
+
+    static constexpr const char *SocketPath = "test_path_server.sock";
+    std::unique_ptr<PathServer> m_server;
+    std::thread m_serverThread;
+};
+
+// Test that batched queries over the socket match local queries
+TEST_F(PathServerTest, BatchQueryMatchesLocalSearch)
+{
+    PathFinder local("test_server_config.json");
+    PathClient client(SocketPath);
+
+    std::vector<PathClient::Query> queries = {
+        {{0, 0}, {3, 3}}, {{2, 0}, {0, 3}}, {{0, 0}, {1, 0}}, {{0, 0}, {0, 0}}};
+    auto paths = client.FindPaths(0, queries);
+    ASSERT_EQ(paths.size(), queries.size());
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        EXPECT_EQ(paths[i], local.FindPath(queries[i].first, queries[i].second));
+    }
+    // Route through the gap in the obstacle row
+    EXPECT_EQ(paths[0].size(), 7u);
+    // Elevated target has no path
+    EXPECT_TRUE(paths[2].empty());
+
+    // The connection stays usable for further requests
+    EXPECT_EQ(client.FindPaths(0, {{{0, 0}, {0, 3}}})[0].size(), 4u);
+}
+
+// Test map info and unknown map handling
+TEST_F(PathServerTest, MapInfoAndUnknownMap)
+{
+    PathClient client(SocketPath);
+    Protocol::MapInfo info = client.GetMapInfo(0);
+    EXPECT_EQ(info.rows, 4);
+    EXPECT_EQ(info.cols, 4);
+    EXPECT_EQ(info.unitCount, 1u);
+
+    EXPECT_THROW(client.FindPaths(7, {{{0, 0}, {3, 3}}}), std::out_of_range);
+}
+
+// Test that a failing query is answered with an error instead of taking the server down. The map
+// is served from a chunk file that is deleted while chunks are evicted, so queries fail to read it
+TEST_F(PathServerTest, FailedQueryKeepsServerRunning)
+{
+    constexpr int Size = 32;
+    nlohmann::json config = {
+        {"mapFile", "test_server_chunk_map.json"},
+        {"chunkSize", 4},
+        {"terrainKeys", {{"start", 0}, {"target", 8}, {"elevated", 3}, {"reachable", -1}}}};
+    writeJsonToFile("test_server_chunk_config.json", config);
+    std::vector<int> data(Size * Size, -1);
+    data.front() = 0;
+    data.back() = 8;
+    writeGridMap("test_server_chunk_map.json", Size, Size, data);
+    PathFinder("test_server_chunk_config.json").ExportChunkFile("test_server.chunks");
+    config["mapFile"] = "test_server.chunks";
+    config["chunkMemoryLimit"] = 4 * 4 * 4 * sizeof(int);
+    writeJsonToFile("test_server_chunk_config.json", config);
+
+    {
+        PathServer server({"test_server_chunk_config.json"}, "test_path_server_chunks.sock", 2);
+        std::thread serverThread([&server]() { server.Run(); });
+        remove("test_server.chunks");
+
+        PathClient client("test_path_server_chunks.sock");
+        EXPECT_THROW(client.FindPaths(0, {{{0, 0}, {Size - 1, Size - 1}}, {{Size - 1, 0}, {0, 0}}}),
+                     std::runtime_error);
+        // The connection and the server survive the failed batch
+        EXPECT_EQ(client.GetMapInfo(0).rows, Size);
+        server.Stop();
+        serverThread.join();
+    }
+    remove("test_server_chunk_config.json");
+    remove("test_server_chunk_map.json");
+}
+
+// Test that clients beyond the connection limit are turned away while the others are served
+TEST_F(PathServerTest, LimitsConnections)
+{
+    EXPECT_THROW(PathServer({"test_server_config.json"}, "test_path_server_limit.sock", 1, 0),
+                 std::invalid_argument);
+    PathServer server({"test_server_config.json"}, "test_path_server_limit.sock", 1, 1);
+    std::thread serverThread([&server]() { server.Run(); });
+
+    PathClient first("test_path_server_limit.sock");
+    EXPECT_EQ(first.FindPaths(0, {{{0, 0}, {3, 3}}})[0].size(), 7u);
+    PathClient second("test_path_server_limit.sock");
+    EXPECT_THROW(second.GetMapInfo(0), std::runtime_error);
+    EXPECT_EQ(first.GetMapInfo(0).rows, 4);
+
+    server.Stop();
+    serverThread.join();
+}
@@ -1,4 +1,5 @@
 #include "../include/PathFinder.hpp"
+#include "test_utils.hpp"
 
 #include <gtest/gtest.h>
 #include <nlohmann/json.hpp>
@@ -23,6 +24,19 @@ void writeJsonToFile(const std::string &filePath, const nlohmann::json &jsonCont
     }
 }
 
+// Utility function to write a map file with a single layer of rows * cols terrain keys
+void writeGridMap(const std::string &filePath, int rows, int cols, const std::vector<int> &data)
+{
+    nlohmann::json mapData;
+    mapData["layers"] = {{{"name", "world"},
+                          {"tileset", "MapEditor Tileset_woodland.png"},
+                          {"data", data}}};
+    mapData["tilesets"] = {{{"name", "MapEditor Tileset_woodland.png"},
+                            {"tilewidth", cols},
+                            {"tileheight", rows}}};
+    writeJsonToFile(filePath, mapData);
+}
+
 // Test fixture for PathFinder tests
 class PathFinderTest : public ::testing::Test
 {
@@ -232,6 +246,176 @@ TEST_F(PathFinderTest, FindPathsOnlyObstacles)
     EXPECT_NO_THROW(pathFinder.FindPaths());
 }
 
+// Test FindPath for a single query on the open map
+TEST_F(PathFinderTest, FindPathSingleQuery)
+{
+    PathFinder pathFinder("test_config.json");
+    std::vector<Position> path = pathFinder.FindPath({0, 0}, {3, 3});
+    // Shortest 4-connected path covers 6 moves
+    ASSERT_EQ(path.size(), 7u);
+    EXPECT_EQ(path.front(), Position(0, 0));
+    EXPECT_EQ(path.back(), Position(3, 3));
+
+    // Out of bounds targets have no path
+    EXPECT_TRUE(pathFinder.FindPath({0, 0}, {4, 4}).empty());
+}
+
+// Test that nearest target queries find the cheapest target with few and with many targets
+TEST_F(PathFinderTest, FindPathToNearest)
+{
+    PathFinder pathFinder("test_config.json");
+    pathFinder.SetTerrain({1, 0}, 3);
+    pathFinder.SetTerrain({1, 1}, 3);
+    // {2, 0} is closer by distance but behind the wall, {0, 3} is closer by path
+    std::vector<Position> path = pathFinder.FindPathToNearest({0, 0}, {{2, 0}, {0, 3}, {4, 4}});
+    ASSERT_EQ(path.size(), 4u);
+    EXPECT_EQ(path.front(), Position(0, 0));
+    EXPECT_EQ(path.back(), Position(0, 3));
+
+    // More targets than the heuristic handles are searched from the targets back to the start
+    std::vector<Position> targets;
+    for (int x = 1; x < 4; ++x)
+    {
+        for (int y = 0; y < 4; ++y)
+        {
+            targets.push_back({x, y});
+        }
+    }
+    ASSERT_GT(targets.size(), PathFinder::MaxHeuristicTargets);
+    path = pathFinder.FindPathToNearest({0, 0}, targets);
+    ASSERT_EQ(path.size(), 4u);
+    EXPECT_EQ(path.front(), Position(0, 0));
+    EXPECT_EQ(path.back(), Position(1, 2));
+
+    EXPECT_TRUE(pathFinder.FindPathToNearest({0, 0}, {{1, 0}, {4, 4}}).empty());
+}
+
+// Test that movement classes plan with the passability of several map layers
+TEST_F(PathFinderTest, MovementClasses)
+{
+    nlohmann::json config = {
+        {"mapFile", "test_map.json"},
+        {"snapshotFile", "test_classes.snapshot"},
+        {"terrainKeys", {{"start", 0}, {"target", 8}, {"elevated", 3}, {"reachable", -1}}},
+        {"movementClasses",
+         {{"ground", {{"world", {3}}, {"water", {1}}}}, {"hover", {{"world", {3}}}}}}};
+    writeJsonToFile("test_config.json", config);
+    // A river runs down the third column
+    std::vector<int> water(16, -1);
+    for (int x = 0; x < 4; ++x)
+    {
+        water[x * 4 + 2] = 1;
+    }
+    nlohmann::json mapData;
+    mapData["layers"] = {{{"name", "world"}, {"data", std::vector<int>(16, -1)}},
+                         {{"name", "water"}, {"data", water}}};
+    mapData["tilesets"] = {{{"tilewidth", 4}, {"tileheight", 4}}};
+    writeJsonToFile("test_map.json", mapData);
+
+    for (int load = 0; load < 2; ++load)
+    {
+        PathFinder pathFinder("test_config.json");
+        EXPECT_EQ(pathFinder.IsLoadedFromSnapshot(), load == 1);
+        PathFinder::QueryOptions ground, hover;
+        ground.movementClass = pathFinder.GetMovementClass("ground");
+        hover.movementClass = pathFinder.GetMovementClass("hover");
+        EXPECT_TRUE(pathFinder.FindPath({0, 0}, {0, 3}, ground).empty());
+        EXPECT_EQ(pathFinder.FindPath({0, 0}, {0, 1}, ground).size(), 2u);
+        EXPECT_EQ(pathFinder.FindPath({0, 0}, {0, 3}, hover).size(), 4u);
+        EXPECT_EQ(pathFinder.FindPath({0, 0}, {0, 3}).size(), 4u);
+
+        // The river splits the ground components, so targets across it are dropped up front
+        const auto version = pathFinder.GetMapVersion();
+        const auto &groundComponents = version->movementClasses[ground.movementClass - 1].components;
+        ASSERT_NE(groundComponents, nullptr);
+        EXPECT_NE(groundComponents->RootAt({0, 0}), groundComponents->RootAt({0, 3}));
+        EXPECT_EQ(pathFinder.FindPathToNearest({0, 0}, {{0, 3}, {3, 1}}, ground).back(),
+                  Position(3, 1));
+
+        // Terrain edits apply to the first layer rules of every class
+        pathFinder.SetTerrain({0, 1}, 3);
+        EXPECT_EQ(pathFinder.FindPath({0, 0}, {0, 3}, hover).size(), 6u);
+        pathFinder.SetTerrain({1, 0}, 3);
+        EXPECT_TRUE(pathFinder.FindPath({0, 0}, {3, 0}, ground).empty());
+        pathFinder.SetTerrain({1, 0}, -1);
+        EXPECT_EQ(pathFinder.FindPath({0, 0}, {3, 0}, ground).size(), 4u);
+    }
+
+    EXPECT_THROW(PathFinder("test_config.json").GetMovementClass("amphibious"),
+                 std::invalid_argument);
+    PathFinder::QueryOptions unknown;
+    unknown.movementClass = 3;
+    EXPECT_THROW(PathFinder("test_config.json").FindPath({0, 0}, {0, 3}, unknown),
+                 std::invalid_argument);
+
+    config["movementClasses"]["amphibious"] = {{"shore", {2}}};
+    writeJsonToFile("test_config.json", config);
+    EXPECT_THROW(PathFinder("test_config.json"), std::runtime_error);
+    remove("test_classes.snapshot");
+}
+
+// Test that the clearance map limits where larger units can stand and move
+TEST_F(PathFinderTest, ClearanceForUnitSizes)
+{
+    PathFinder pathFinder("test_config.json");
+    EXPECT_EQ(pathFinder.GetClearance({0, 0}), 4);
+    EXPECT_EQ(pathFinder.GetClearance({2, 2}), 2);
+    EXPECT_EQ(pathFinder.GetClearance({3, 3}), 1);
+    EXPECT_EQ(pathFinder.GetClearance({4, 4}), 0);
+
+    PathFinder::QueryOptions options;
+    options.unitSize = 2;
+    EXPECT_EQ(pathFinder.FindPath({0, 0}, {2, 2}, options).size(), 5u);
+    // A 2x2 unit anchored at the corner would leave the map
+    EXPECT_TRUE(pathFinder.FindPath({0, 0}, {3, 3}, options).empty());
+}
+
+// Test that terrain changes update the clearance map incrementally
+TEST_F(PathFinderTest, SetTerrainUpdatesClearance)
+{
+    PathFinder pathFinder("test_config.json");
+    auto bruteForceClearance = [&](const Position &pos)
+    {
+        int size = 0;
+        while (true)
+        {
+            for (int x = pos.x; x <= pos.x + size; ++x)
+            {
+                for (int y = pos.y; y <= pos.y + size; ++y)
+                {
+                    if (x >= 4 || y >= 4 || pathFinder.GetMap().At(x, y) == 3)
+                    {
+                        return size;
+                    }
+                }
+            }
+            ++size;
+        }
+    };
+
+    pathFinder.SetTerrain({1, 1}, 3);
+    pathFinder.SetTerrain({3, 0}, 3);
+    pathFinder.SetTerrain({3, 0}, -1);
+    for (int x = 0; x < 4; ++x)
+    {
+        for (int y = 0; y < 4; ++y)
+        {
+            EXPECT_EQ(pathFinder.GetClearance({x, y}), bruteForceClearance({x, y}))
+                << x << ", " << y;
+        }
+    }
+
+    PathFinder::QueryOptions options;
+    options.unitSize = 2;
+    EXPECT_TRUE(pathFinder.FindPath({0, 0}, {2, 2}, options).empty());
+    EXPECT_EQ(pathFinder.FindPath({2, 0}, {0, 2}, options).size(), 5u);
+    EXPECT_FALSE(pathFinder.AreConnected({0, 1}, {1, 1}));
+
+    pathFinder.SetTerrain({1, 1}, -1);
+    EXPECT_EQ(pathFinder.GetClearance({0, 0}), 4);
+    EXPECT_TRUE(pathFinder.AreConnected({0, 1}, {1, 1}));
+}
+
 // Test parseConfig and parseMap for modified config file
 TEST_F(PathFinderTest, MapParserCustomConfig)
 {
@@ -0,0 +1,171 @@
+#include "../include/PortfolioSearch.hpp"
+#include "../include/PathFinder.hpp"
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace PathPlanner;
+using Position = PathPlanner::PathFinder::Position;
+using Engine = PathPlanner::PortfolioSearch::Engine;
+
+// Test fixture for portfolio search tests
+class PortfolioSearchTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        m_config = {
+            {"mapFile", "test_portfolio_map.json"},
+            {"headless", true},
+            {"contractionHierarchy", true},
+            {"terrainKeys", {{"start", 0}, {"target", 8}, {"elevated", 3}, {"reachable", -1}}}};
+        writeJsonToFile("test_portfolio_config.json", m_config);
+
+        // Random obstacles with the last cell walled in
+        std::mt19937 random(11);
+        std::vector<int> data(Size * Size);
+        for (auto &cell : data)
+        {
+            cell = random() % 4 == 0 ? 3 : -1;
+        }
+        data[0] = data[1] = data[Size] = -1;
+        data.back() = -1;
+        data[Size * Size - 2] = data[Size * Size - 1 - Size] = 3;
+
+        writeGridMap("test_portfolio_map.json", Size, Size, data);
+    }
+
+    void TearDown() override
+    {
+        // Clean up files
+        remove("test_portfolio_config.json");
+        remove("test_portfolio_map.json");
+    }
+
+    static constexpr int Size = 24;
+    nlohmann::json m_config;
+};
+
+// Test that the first answer of any engine is a shortest path and that every win is counted
+TEST_F(PortfolioSearchTest, MatchesFindPath)
+{
+    PathFinder pathFinder("test_portfolio_config.json");
+    PortfolioSearch::Options options;
+    options.engines = {Engine::AStar, Engine::ContractionHierarchy, Engine::Frontier};
+    PortfolioSearch portfolio(pathFinder, options);
+
+    std::mt19937 random(5);
+    uint64_t raced = 0;
+    for (int query = 0; query < 40; ++query)
+    {
+        const Position start(random() % Size, random() % Size);
+        const Position target(random() % Size, random() % Size);
+        const std::vector<Position> expected = pathFinder.FindPath(start, target);
+        PortfolioSearch::Result result = portfolio.FindPath(start, target);
+        EXPECT_EQ(result.path.size(), expected.size());
+        if (!expected.empty())
+        {
+            EXPECT_EQ(result.path.front(), start);
+            EXPECT_EQ(result.path.back(), target);
+            EXPECT_TRUE(result.winner.has_value());
+            ++raced;
+        }
+    }
+    EXPECT_GT(raced, 0u);
+    EXPECT_EQ(portfolio.GetWins(Engine::AStar) + portfolio.GetWins(Engine::ContractionHierarchy) +
+                  portfolio.GetWins(Engine::Frontier),
+              raced);
+
+    // Queries the connectivity check rejects never reach the engines
+    PortfolioSearch::Result result = portfolio.FindPath({0, 0}, {Size - 1, Size - 1});
+    EXPECT_TRUE(result.path.empty());
+    EXPECT_FALSE(result.winner.has_value());
+}
+
+// Test that invalid engine lists are rejected
+TEST_F(PortfolioSearchTest, ValidatesEngines)
+{
+    PathFinder pathFinder("test_portfolio_config.json");
+    PortfolioSearch::Options options;
+    options.engines = {};
+    EXPECT_THROW(PortfolioSearch(pathFinder, options), std::invalid_argument);
+    options.engines = {Engine::AStar, Engine::AStar};
+    EXPECT_THROW(PortfolioSearch(pathFinder, options), std::invalid_argument);
+
+    m_config["contractionHierarchy"] = false;
+    writeJsonToFile("test_portfolio_config.json", m_config);
+    PathFinder plainPathFinder("test_portfolio_config.json");
+    options.engines = {Engine::AStar, Engine::ContractionHierarchy};
+    EXPECT_THROW(PortfolioSearch(plainPathFinder, options), std::invalid_argument);
+    EXPECT_NO_THROW(PortfolioSearch{plainPathFinder});
+}
+
+// Test that a hierarchy dropped by an edit is reported as an A* win
+TEST_F(PortfolioSearchTest, CreditsEngineThatAnswered)
+{
+    m_config["shareMap"] = false;
+    writeJsonToFile("test_portfolio_config.json", m_config);
+    PathFinder pathFinder("test_portfolio_config.json");
+    PortfolioSearch::Options options;
+    options.engines = {Engine::ContractionHierarchy};
+    PortfolioSearch portfolio(pathFinder, options);
+
+    PortfolioSearch::Result result = portfolio.FindPath({0, 0}, {0, 1});
+    ASSERT_TRUE(result.winner.has_value());
+    EXPECT_EQ(*result.winner, Engine::ContractionHierarchy);
+
+    pathFinder.SetTerrain({1, 0}, 3);
+    ASSERT_FALSE(pathFinder.HasContractionHierarchy());
+    result = portfolio.FindPath({0, 0}, {0, 1});
+    EXPECT_EQ(result.path.size(), 2u);
+    ASSERT_TRUE(result.winner.has_value());
+    EXPECT_EQ(*result.winner, Engine::AStar);
+    EXPECT_EQ(portfolio.GetWins(Engine::ContractionHierarchy), 1u);
+    EXPECT_EQ(portfolio.GetWins(Engine::AStar), 1u);
+}
+
+// Test that the engine losing the race is stopped instead of running to the end. The hierarchy
+// answers a long corridor in microseconds, while the frontier search needs thousands of expansions
+TEST_F(PortfolioSearchTest, StopsLosingEngines)
+{
+    constexpr int MazeSize = 64;
+    std::vector<int> data(MazeSize * MazeSize, -1);
+    for (int row = 1; row < MazeSize; row += 2)
+    {
+        for (int col = 0; col < MazeSize; ++col)
+        {
+            data[row * MazeSize + col] = 3;
+        }
+        data[row * MazeSize + (row % 4 == 1 ? MazeSize - 1 : 0)] = -1;
+    }
+    writeGridMap("test_portfolio_map.json", MazeSize, MazeSize, data);
+    m_config["shareMap"] = false;
+    writeJsonToFile("test_portfolio_config.json", m_config);
+
+    PathFinder pathFinder("test_portfolio_config.json");
+    PortfolioSearch::Options options;
+    options.engines = {Engine::ContractionHierarchy, Engine::Frontier};
+    PortfolioSearch portfolio(pathFinder, options);
+
+    size_t stopped = 0;
+    for (int query = 0; query < 10; ++query)
+    {
+        const Position start(0, query);
+        const Position target(MazeSize - 2, MazeSize - 1 - query);
+        PortfolioSearch::Result result = portfolio.FindPath(start, target);
+        EXPECT_EQ(result.path.size(), pathFinder.FindPath(start, target).size());
+        EXPECT_LE(result.stoppedEngines, 1u);
+        if (result.stoppedEngines > 0)
+        {
+            EXPECT_EQ(*result.winner, Engine::ContractionHierarchy);
+        }
+        stopped += result.stoppedEngines;
+    }
+    EXPECT_GT(stopped, 0u);
+}
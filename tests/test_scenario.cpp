@@ -0,0 +1,111 @@
+#include "../include/PathFinder.hpp"
+#include "../include/Scenario.hpp"
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+using namespace PathPlanner;
+using Position = PathPlanner::PathFinder::Position;
+
+// Test fixture for Moving AI map and scenario tests
+class ScenarioTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        nlohmann::json config = {
+            {"mapFile", "test_scenario.map"},
+            {"terrainKeys", {{"start", 0}, {"target", 8}, {"elevated", 3}, {"reachable", -1}}}};
+        writeJsonToFile("test_scenario_config.json", config);
+
+        std::ofstream map("test_scenario.map");
+        map << "type octile\nheight 4\nwidth 5\nmap\n"
+            << ".....\n"
+            << ".@@..\n"
+            << ".....\n"
+            << "T....\n";
+        map.close();
+
+        // Bucket 1 holds a wrong optimal length and a query to a blocked cell
+        std::ofstream scen("test_scenario.scen");
+        scen << "version 1\n"
+             << "0\ttest_scenario.map\t5\t4\t0\t0\t4\t2\t5.41421356\n"
+             << "0\ttest_scenario.map\t5\t4\t3\t3\t3\t3\t0\n"
+             << "1\ttest_scenario.map\t5\t4\t0\t0\t4\t2\t3.00000000\n"
+             << "1\ttest_scenario.map\t5\t4\t4\t0\t0\t3\t6.00000000\n";
+        scen.close();
+    }
+
+    void TearDown() override
+    {
+        // Clean up files
+        remove("test_scenario_config.json");
+        remove("test_scenario.map");
+        remove("test_scenario.scen");
+    }
+};
+
+// Test that Moving AI maps are read with blocked tiles mapped to the elevated terrain key
+TEST_F(ScenarioTest, LoadsMovingAIMap)
+{
+    PathFinder pathFinder("test_scenario_config.json");
+    ChunkedGrid map = pathFinder.GetMap();
+    EXPECT_EQ(map.Rows(), 4);
+    EXPECT_EQ(map.Cols(), 5);
+    EXPECT_EQ(map.At(0, 0), -1);
+    EXPECT_EQ(map.At(1, 2), 3);
+    EXPECT_EQ(map.At(3, 0), 3);
+    EXPECT_EQ(pathFinder.GetUnitCount(), 0u);
+
+    std::ofstream("test_scenario.map") << "type octile\nheight 2\nwidth 3\nmap\n...\n..\n";
+    EXPECT_THROW(PathFinder("test_scenario_config.json"), std::runtime_error);
+}
+
+// Test that diagonal searches find octile optimal paths without cutting corners
+TEST_F(ScenarioTest, DiagonalSearch)
+{
+    PathFinder pathFinder("test_scenario_config.json");
+    PathFinder::QueryOptions options;
+    options.allowDiagonal = true;
+    const std::vector<Position> path = pathFinder.FindPath({0, 0}, {2, 4}, options);
+    EXPECT_NEAR(Scenario::PathLength(path), 4 + std::sqrt(2.0), 1e-9);
+    for (size_t i = 1; i < path.size(); ++i)
+    {
+        // Both cells beside a diagonal move are free
+        EXPECT_TRUE(pathFinder.IsTraversable({path[i].x, path[i - 1].y}));
+        EXPECT_TRUE(pathFinder.IsTraversable({path[i - 1].x, path[i].y}));
+    }
+
+    // On open ground diagonal moves shorten the path, next to a blocked cell they are not allowed
+    EXPECT_EQ(pathFinder.FindPath({2, 0}, {3, 1}, options).size(), 3u);
+    EXPECT_EQ(pathFinder.FindPath({2, 1}, {3, 2}, options).size(), 2u);
+    EXPECT_EQ(pathFinder.FindPath({2, 1}, {3, 2}).size(), 3u);
+}
+
+// Test scenario parsing and that wrong lengths and missing paths are reported per bucket
+TEST_F(ScenarioTest, RunsScenario)
+{
+    PathFinder pathFinder("test_scenario_config.json");
+    const Scenario scenario = Scenario::Load("test_scenario.scen");
+    ASSERT_EQ(scenario.GetQueries().size(), 4u);
+    // Scenario x coordinates are columns
+    EXPECT_EQ(scenario.GetQueries()[0].target, Position(2, 4));
+    EXPECT_EQ(scenario.GetQueries()[3].start, Position(0, 4));
+
+    const Scenario::Report report = scenario.Run(pathFinder);
+    ASSERT_EQ(report.buckets.size(), 2u);
+    EXPECT_EQ(report.buckets[0].queries, 2u);
+    EXPECT_EQ(report.buckets[0].failures, 0u);
+    EXPECT_EQ(report.buckets[1].failures, 2u);
+    EXPECT_LE(report.buckets[0].p50Microseconds, report.buckets[0].maxMicroseconds);
+    EXPECT_EQ(report.failedQueries, std::vector<size_t>({2, 3}));
+
+    std::ofstream("test_scenario.scen") << "version 1\n0\ttest_scenario.map\t5\t4\t0\n";
+    EXPECT_THROW(Scenario::Load("test_scenario.scen"), std::runtime_error);
+}
@@ -0,0 +1,137 @@
+#include "../include/PathFinder.hpp"
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace PathPlanner;
+using Position = PathPlanner::PathFinder::Position;
+
+// Test fixture for shared map version tests
+class SharedMapTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        nlohmann::json config = {
+            {"mapFile", "test_shared_map.json"},
+            {"terrainKeys", {{"start", 0}, {"target", 8}, {"elevated", 3}, {"reachable", -1}}}};
+        writeJsonToFile("test_shared_config.json", config);
+
+        writeGridMap("test_shared_map.json", 4, 4,
+                     {0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 8});
+    }
+
+    void TearDown() override
+    {
+        // Clean up files
+        remove("test_shared_config.json");
+        remove("test_shared_map.json");
+    }
+};
+
+// Test that instances loading the same inputs reuse one map version
+TEST_F(SharedMapTest, InstancesShareVersion)
+{
+    PathFinder first("test_shared_config.json");
+    PathFinder second("test_shared_config.json");
+    EXPECT_FALSE(first.IsSharingMap());
+    EXPECT_TRUE(second.IsSharingMap());
+    EXPECT_EQ(first.GetMapVersion(), second.GetMapVersion());
+    EXPECT_EQ(second.FindPath({0, 0}, {3, 3}).size(), 7u);
+}
+
+// Test that edits publish a new version and leave held versions and other instances untouched
+TEST_F(SharedMapTest, SetTerrainPublishesNewVersion)
+{
+    PathFinder first("test_shared_config.json");
+    PathFinder second("test_shared_config.json");
+    auto original = first.GetMapVersion();
+
+    first.SetTerrain({1, 1}, 3);
+    auto edited = first.GetMapVersion();
+    EXPECT_NE(edited, original);
+    EXPECT_EQ(edited->revision, original->revision + 1);
+    EXPECT_EQ(edited->map.At(1, 1), 3);
+    EXPECT_EQ(original->map.At(1, 1), -1);
+    EXPECT_EQ(second.GetMapVersion(), original);
+    EXPECT_EQ(second.GetClearance({0, 0}), 4);
+    EXPECT_EQ(first.GetClearance({0, 0}), 1);
+
+    // Edits that keep traversability reuse the derived structures
+    first.SetTerrain({2, 2}, 0);
+    EXPECT_EQ(first.GetMapVersion()->clearance, edited->clearance);
+    EXPECT_EQ(first.GetMapVersion()->componentLabels, edited->componentLabels);
+}
+
+// Test that edits update the component labels without relabeling the map
+TEST_F(SharedMapTest, SetTerrainUpdatesComponents)
+{
+    // A wall splits the map into two components
+    writeGridMap("test_shared_map.json", 4, 4,
+                 {0, -1, -1, -1, 3, 3, 3, 3, -1, -1, -1, -1, -1, -1, -1, 8});
+    PathFinder pathFinder("test_shared_config.json");
+    EXPECT_FALSE(pathFinder.AreConnected({0, 0}, {3, 3}));
+
+    // A cell opened in the wall merges them
+    pathFinder.SetTerrain({1, 2}, -1);
+    EXPECT_TRUE(pathFinder.AreConnected({0, 0}, {3, 3}));
+    EXPECT_EQ(pathFinder.FindPath({0, 0}, {3, 3}).size(), 7u);
+
+    // Blocking never splits a component, the search finds out instead
+    pathFinder.SetTerrain({1, 2}, 3);
+    EXPECT_FALSE(pathFinder.AreConnected({0, 0}, {1, 2}));
+    EXPECT_TRUE(pathFinder.AreConnected({0, 0}, {3, 3}));
+    EXPECT_TRUE(pathFinder.FindPath({0, 0}, {3, 3}).empty());
+
+    // A cell opened without open neighbors starts its own component
+    pathFinder.SetTerrain({2, 0}, 3);
+    pathFinder.SetTerrain({3, 1}, 3);
+    pathFinder.SetTerrain({3, 0}, 3);
+    pathFinder.SetTerrain({3, 0}, -1);
+    EXPECT_FALSE(pathFinder.AreConnected({3, 0}, {3, 3}));
+    pathFinder.SetTerrain({3, 1}, -1);
+    EXPECT_TRUE(pathFinder.AreConnected({3, 0}, {3, 3}));
+}
+
+// Test that searches running during edits always see a consistent version
+TEST_F(SharedMapTest, ConcurrentSearchesDuringEdits)
+{
+    PathFinder pathFinder("test_shared_config.json");
+    std::atomic<bool> done{false};
+    std::atomic<int> failures{0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 2; ++i)
+    {
+        readers.emplace_back(
+            [&]()
+            {
+                while (!done.load())
+                {
+                    // The border cells are never edited, so a path always exists
+                    std::vector<Position> path = pathFinder.FindPath({0, 0}, {3, 3});
+                    if (path.size() != 7u)
+                    {
+                        ++failures;
+                    }
+                }
+            });
+    }
+
+    for (int i = 0; i < 200; ++i)
+    {
+        pathFinder.SetTerrain({1 + i % 2, 1 + (i / 2) % 2}, i % 3 == 0 ? 3 : -1);
+    }
+    done = true;
+    for (auto &reader : readers)
+    {
+        reader.join();
+    }
+    EXPECT_EQ(failures.load(), 0);
+    EXPECT_EQ(pathFinder.GetMapVersion()->revision, 200u);
+}
@@ -0,0 +1,106 @@
+#include "../include/PathFinder.hpp"
+#include "../include/Snapshot.hpp"
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <cstdio>
+#include <fstream>
+
+using namespace PathPlanner;
+using Position = PathPlanner::PathFinder::Position;
+
+// Test fixture for snapshot tests
+class SnapshotTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        m_config = {
+            {"mapFile", "test_snapshot_map.json"},
+            {"snapshotFile", "test_snapshot.bin"},
+            // Instances alive at the same time would otherwise share instead of reading the file
+            {"shareMap", false},
+            {"terrainKeys", {{"start", 0}, {"target", 8}, {"elevated", 3}, {"reachable", -1}}}};
+        writeJsonToFile("test_snapshot_config.json", m_config);
+        writeMap({0, -1, -1, -1, 3, 3, 3, -1, -1, -1, -1, -1, 0, 3, 3, 8});
+    }
+
+    void writeMap(const std::vector<int> &data)
+    {
+        writeGridMap("test_snapshot_map.json", 4, 4, data);
+    }
+
+    void TearDown() override
+    {
+        // Clean up files
+        remove("test_snapshot_config.json");
+        remove("test_snapshot_map.json");
+        remove("test_snapshot.bin");
+    }
+
+    nlohmann::json m_config;
+};
+
+// Test that the second start loads the snapshot and matches the parsed map
+TEST_F(SnapshotTest, WarmStartMatchesColdStart)
+{
+    PathFinder cold("test_snapshot_config.json");
+    EXPECT_FALSE(cold.IsLoadedFromSnapshot());
+
+    PathFinder warm("test_snapshot_config.json");
+    EXPECT_TRUE(warm.IsLoadedFromSnapshot());
+
+    ASSERT_EQ(warm.GetUnitCount(), cold.GetUnitCount());
+    for (int i = 0; i < static_cast<int>(cold.GetUnitCount()); ++i)
+    {
+        EXPECT_EQ(warm.GetStartPosition(i), cold.GetStartPosition(i));
+        EXPECT_EQ(warm.GetTargetPosition(i), cold.GetTargetPosition(i));
+    }
+    for (int x = 0; x < 4; ++x)
+    {
+        for (int y = 0; y < 4; ++y)
+        {
+            EXPECT_EQ(warm.GetMap().At(x, y), cold.GetMap().At(x, y));
+            EXPECT_EQ(warm.AreConnected({0, 0}, {x, y}), cold.AreConnected({0, 0}, {x, y}));
+        }
+    }
+    EXPECT_EQ(warm.FindPath({0, 0}, {3, 3}), cold.FindPath({0, 0}, {3, 3}));
+}
+
+// Test that edits to the map file or the terrain keys invalidate the snapshot
+TEST_F(SnapshotTest, ChangedInputsRebuild)
+{
+    PathFinder first("test_snapshot_config.json");
+
+    writeMap({0, -1, -1, -1, 3, 3, 3, 3, -1, -1, -1, -1, 0, 3, 3, 8});
+    PathFinder editedMap("test_snapshot_config.json");
+    EXPECT_FALSE(editedMap.IsLoadedFromSnapshot());
+    EXPECT_FALSE(editedMap.AreConnected({0, 0}, {3, 3}));
+
+    m_config["terrainKeys"]["reachable"] = -2;
+    writeJsonToFile("test_snapshot_config.json", m_config);
+    PathFinder editedKeys("test_snapshot_config.json");
+    EXPECT_FALSE(editedKeys.IsLoadedFromSnapshot());
+
+    PathFinder warm("test_snapshot_config.json");
+    EXPECT_TRUE(warm.IsLoadedFromSnapshot());
+}
+
+// Test that a corrupt snapshot falls back to parsing the map
+TEST_F(SnapshotTest, CorruptSnapshotRebuilds)
+{
+    PathFinder first("test_snapshot_config.json");
+    {
+        // Keep the header but cut off the sections
+        std::ifstream in("test_snapshot.bin", std::ios::binary);
+        std::string header(20, '\0');
+        in.read(header.data(), header.size());
+        std::ofstream out("test_snapshot.bin", std::ios::binary | std::ios::trunc);
+        out << header << "garbage";
+    }
+    PathFinder rebuilt("test_snapshot_config.json");
+    EXPECT_FALSE(rebuilt.IsLoadedFromSnapshot());
+    EXPECT_EQ(rebuilt.FindPath({0, 0}, {3, 3}).size(), 7u);
+}
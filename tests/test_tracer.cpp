@@ -0,0 +1,125 @@
+#include "../include/PathFinder.hpp"
+#include "../include/Tracer.hpp"
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <thread>
+
+using namespace PathPlanner;
+
+// Test fixture for tracer tests
+class TracerTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override { Tracer::Clear(); }
+
+    void TearDown() override
+    {
+        Tracer::Disable();
+        Tracer::Clear();
+        // Clean up files
+        remove("test_trace.json");
+        remove("test_trace_config.json");
+        remove("test_trace_map.json");
+    }
+
+    // Export the current trace and return its complete events
+    std::vector<nlohmann::json> exportSpans()
+    {
+        Tracer::WriteChromeTrace("test_trace.json");
+        std::ifstream file("test_trace.json");
+        nlohmann::json trace = nlohmann::json::parse(file);
+        std::vector<nlohmann::json> spans;
+        for (const auto &event : trace["traceEvents"])
+        {
+            if (event["ph"] == "X")
+            {
+                spans.push_back(event);
+            }
+        }
+        return spans;
+    }
+};
+
+// Test that nothing is recorded while tracing is disabled
+TEST_F(TracerTest, DisabledRecordsNothing)
+{
+    {
+        TraceSpan span("ignored");
+    }
+    EXPECT_TRUE(exportSpans().empty());
+}
+
+// Test that spans of several threads are exported on separate tracks with their arguments
+TEST_F(TracerTest, RecordsSpansPerThread)
+{
+    Tracer::Enable();
+    auto work = [](int64_t id) { TraceSpan span("work", "test", "id", id); };
+    std::thread first(work, 1);
+    std::thread second(work, 2);
+    first.join();
+    second.join();
+
+    auto spans = exportSpans();
+    ASSERT_EQ(spans.size(), 2u);
+    std::set<int64_t> ids;
+    std::set<int> threads;
+    for (const auto &span : spans)
+    {
+        EXPECT_EQ(span["name"], "work");
+        EXPECT_EQ(span["cat"], "test");
+        EXPECT_GE(span["dur"].get<double>(), 0.0);
+        ids.insert(span["args"]["id"].get<int64_t>());
+        threads.insert(span["tid"].get<int>());
+    }
+    EXPECT_EQ(ids, (std::set<int64_t>{1, 2}));
+    EXPECT_EQ(threads.size(), 2u);
+}
+
+// Test that a full buffer keeps the most recent spans
+TEST_F(TracerTest, RingBufferKeepsNewest)
+{
+    Tracer::Enable(4);
+    for (int64_t i = 0; i < 10; ++i)
+    {
+        TraceSpan span("step", "test", "i", i);
+    }
+
+    auto spans = exportSpans();
+    ASSERT_EQ(spans.size(), 4u);
+    for (size_t i = 0; i < spans.size(); ++i)
+    {
+        EXPECT_EQ(spans[i]["args"]["i"].get<int64_t>(), static_cast<int64_t>(6 + i));
+    }
+}
+
+// Test that loading a map and solving paths records the load and search phases
+TEST_F(TracerTest, PathFinderPhases)
+{
+    writeJsonToFile("test_trace_config.json",
+                    {{"mapFile", "test_trace_map.json"},
+                     {"headless", true},
+                     {"terrainKeys",
+                      {{"start", 0}, {"target", 8}, {"elevated", 3}, {"reachable", -1}}}});
+    writeGridMap("test_trace_map.json", 2, 2, {0, -1, 3, 8});
+
+    Tracer::Enable();
+    PathFinder pathFinder("test_trace_config.json");
+    pathFinder.FindPaths();
+
+    std::set<std::string> names;
+    for (const auto &span : exportSpans())
+    {
+        names.insert(span["name"].get<std::string>());
+    }
+    for (const char *phase : {"parseConfig", "parseMap", "validateMapPositions", "FindPaths",
+                              "ExpandUnit", "Output"})
+    {
+        EXPECT_TRUE(names.count(phase)) << phase;
+    }
+}
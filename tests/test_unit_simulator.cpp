@@ -0,0 +1,169 @@
+#include "../include/PathFinder.hpp"
+#include "../include/UnitSimulator.hpp"
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace PathPlanner;
+using Position = PathPlanner::PathFinder::Position;
+
+// Test fixture for unit simulator tests
+class UnitSimulatorTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        nlohmann::json config = {
+            {"mapFile", "test_simulator_map.json"},
+            {"headless", true},
+            {"terrainKeys", {{"start", 0}, {"target", 8}, {"elevated", 3}, {"reachable", -1}}}};
+        writeJsonToFile("test_simulator_config.json", config);
+    }
+
+    // Open map without units
+    void writeMap(int rows, int cols)
+    {
+        writeGridMap("test_simulator_map.json", rows, cols, std::vector<int>(rows * cols, -1));
+    }
+
+    // Every unit stands on its own cell and the spatial hash agrees
+    void expectConsistent(const UnitSimulator &simulator)
+    {
+        std::set<std::pair<int, int>> cells;
+        for (UnitSimulator::UnitId unit = 0; unit < simulator.GetUnitCount(); ++unit)
+        {
+            const Position pos = simulator.GetPosition(unit);
+            EXPECT_TRUE(cells.insert({pos.x, pos.y}).second) << "Unit " << unit;
+            EXPECT_TRUE(simulator.IsOccupied(pos));
+        }
+    }
+
+    void TearDown() override
+    {
+        // Clean up files
+        remove("test_simulator_config.json");
+        remove("test_simulator_map.json");
+    }
+};
+
+// Test that a unit advances one cell per tick until it arrives
+TEST_F(UnitSimulatorTest, WalksPath)
+{
+    writeMap(4, 4);
+    PathFinder pathFinder("test_simulator_config.json");
+    UnitSimulator simulator(pathFinder);
+    UnitSimulator::UnitId unit = simulator.AddUnit({0, 0}, {3, 3});
+    EXPECT_THROW(simulator.AddUnit({0, 0}, {1, 1}), std::invalid_argument);
+
+    for (int tick = 0; tick < 6; ++tick)
+    {
+        EXPECT_EQ(simulator.GetState(unit), UnitSimulator::UnitState::Moving);
+        simulator.Tick();
+    }
+    EXPECT_EQ(simulator.GetState(unit), UnitSimulator::UnitState::Arrived);
+    EXPECT_EQ(simulator.GetPosition(unit), Position(3, 3));
+    EXPECT_FALSE(simulator.IsOccupied({0, 0}));
+    EXPECT_EQ(simulator.GetStats().moves, 6u);
+    EXPECT_EQ(simulator.GetStats().arrived, 1u);
+    EXPECT_GT(simulator.GetStats().ticksPerSecond, 0);
+}
+
+// Test that units meeting head on resolve the blockage and both arrive
+TEST_F(UnitSimulatorTest, ResolvesHeadOnBlockage)
+{
+    writeMap(2, 6);
+    PathFinder pathFinder("test_simulator_config.json");
+    UnitSimulator simulator(pathFinder);
+    UnitSimulator::UnitId east = simulator.AddUnit({0, 0}, {0, 5});
+    UnitSimulator::UnitId west = simulator.AddUnit({0, 5}, {0, 0});
+
+    for (int tick = 0; tick < 30; ++tick)
+    {
+        simulator.Tick();
+        expectConsistent(simulator);
+    }
+    EXPECT_EQ(simulator.GetPosition(east), Position(0, 5));
+    EXPECT_EQ(simulator.GetPosition(west), Position(0, 0));
+    EXPECT_GT(simulator.GetStats().waits, 0u);
+    EXPECT_GT(simulator.GetStats().sidesteps + simulator.GetStats().replans, 0u);
+}
+
+// Test that units replan when the terrain on their path changes
+TEST_F(UnitSimulatorTest, ReplansAfterTerrainChange)
+{
+    writeMap(3, 3);
+    PathFinder pathFinder("test_simulator_config.json");
+    UnitSimulator simulator(pathFinder);
+    UnitSimulator::UnitId unit = simulator.AddUnit({0, 0}, {0, 2});
+    pathFinder.SetTerrain({0, 1}, 3);
+
+    for (int tick = 0; tick < 10; ++tick)
+    {
+        simulator.Tick();
+    }
+    EXPECT_EQ(simulator.GetPosition(unit), Position(0, 2));
+    EXPECT_EQ(simulator.GetStats().replans, 1u);
+}
+
+// Test that a crowd of units keeps the occupancy consistent while moving to distinct targets
+TEST_F(UnitSimulatorTest, CrowdStaysConsistent)
+{
+    writeMap(24, 24);
+    PathFinder pathFinder("test_simulator_config.json");
+    UnitSimulator simulator(pathFinder);
+
+    std::mt19937 random(7);
+    std::vector<Position> cells;
+    for (int x = 0; x < 24; ++x)
+    {
+        for (int y = 0; y < 24; ++y)
+        {
+            cells.push_back({x, y});
+        }
+    }
+    std::shuffle(cells.begin(), cells.end(), random);
+    const size_t unitCount = 100;
+    for (size_t i = 0; i < unitCount; ++i)
+    {
+        simulator.AddUnit(cells[i], cells[cells.size() - 1 - i]);
+    }
+
+    for (int tick = 0; tick < 200; ++tick)
+    {
+        simulator.Tick();
+    }
+    expectConsistent(simulator);
+    EXPECT_GT(simulator.GetStats().arrived, unitCount * 9 / 10);
+}
+
+// Test that a boxed in unit backs off between failed replans instead of searching every few ticks
+TEST_F(UnitSimulatorTest, BacksOffFailedReplans)
+{
+    writeMap(1, 3);
+    PathFinder pathFinder("test_simulator_config.json");
+    UnitSimulator::Options options;
+    options.replanRadius = 0;
+    EXPECT_THROW(UnitSimulator(pathFinder, options), std::invalid_argument);
+
+    UnitSimulator simulator(pathFinder);
+    UnitSimulator::UnitId unit = simulator.AddUnit({0, 0}, {0, 2});
+    simulator.AddUnit({0, 1}, {0, 1});
+    for (int tick = 0; tick < 100; ++tick)
+    {
+        simulator.Tick();
+    }
+    // Failed replans wait 6, 12, 24 and 48 blocked ticks, the fifth would come after 96 more
+    EXPECT_EQ(simulator.GetPosition(unit), Position(0, 0));
+    EXPECT_EQ(simulator.GetState(unit), UnitSimulator::UnitState::Moving);
+    EXPECT_EQ(simulator.GetStats().failedReplans, 4u);
+    EXPECT_EQ(simulator.GetStats().replans, 0u);
+}
@@ -0,0 +1,16 @@
+#ifndef TEST_UTILS_HPP
+#define TEST_UTILS_HPP
+
+#include <nlohmann/json.hpp>
+
+#include <string>
+#include <vector>
+
+// Helpers shared by the test files, defined in test_pathfinder.cpp
+
+// Write JSON content to a file, throws std::ios_base::failure if it cannot be opened
+void writeJsonToFile(const std::string &filePath, const nlohmann::json &jsonContent);
+// Write a map file with a single "world" layer, data holds the terrain keys row by row
+void writeGridMap(const std::string &filePath, int rows, int cols, const std::vector<int> &data);
+
+#endif // TEST_UTILS_HPP